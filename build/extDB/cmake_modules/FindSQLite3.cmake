@@ -0,0 +1,43 @@
+# - Find sqlite3
+# Find the native SQLite includes and library
+#
+#  SQLITE3_INCLUDE_DIR - where to find sqlite3.h, etc.
+#  SQLITE3_LIBRARIES   - List of libraries when using SQLite.
+#  SQLITE3_FOUND       - True if SQLite found.
+
+FIND_PATH(SQLITE3_INCLUDE_DIR NAMES sqlite3.h
+  PATHS
+  /usr/local/include
+  /usr/include
+  C:/local/sqlite3
+)
+
+SET(SQLITE3_NAMES sqlite3)
+FIND_LIBRARY(SQLITE3_LIBRARY
+  NAMES ${SQLITE3_NAMES}
+  PATHS /usr/lib /usr/lib/i386-linux-gnu /usr/local/lib C:/local/sqlite3
+)
+
+IF (SQLITE3_INCLUDE_DIR AND SQLITE3_LIBRARY)
+  SET(SQLITE3_FOUND TRUE)
+  SET( SQLITE3_LIBRARIES ${SQLITE3_LIBRARY} )
+ELSE (SQLITE3_INCLUDE_DIR AND SQLITE3_LIBRARY)
+  SET(SQLITE3_FOUND FALSE)
+  SET( SQLITE3_LIBRARIES )
+ENDIF (SQLITE3_INCLUDE_DIR AND SQLITE3_LIBRARY)
+
+IF (SQLITE3_FOUND)
+  IF (NOT SQLITE3_FIND_QUIETLY)
+    MESSAGE(STATUS "Found SQLite: ${SQLITE3_LIBRARY}")
+  ENDIF (NOT SQLITE3_FIND_QUIETLY)
+ELSE (SQLITE3_FOUND)
+  IF (SQLITE3_FIND_REQUIRED)
+    MESSAGE(STATUS "Looked for SQLite libraries named ${SQLITE3_NAMES}.")
+    MESSAGE(FATAL_ERROR "Could NOT find SQLite library")
+  ENDIF (SQLITE3_FIND_REQUIRED)
+ENDIF (SQLITE3_FOUND)
+
+MARK_AS_ADVANCED(
+  SQLITE3_LIBRARY
+  SQLITE3_INCLUDE_DIR
+  )
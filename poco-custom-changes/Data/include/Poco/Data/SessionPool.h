@@ -45,8 +45,11 @@
 #include "Poco/Data/PooledSessionHolder.h"
 #include "Poco/Data/PooledSessionImpl.h"
 #include "Poco/Data/Session.h"
+#include "Poco/Data/StatementLRUCache.h"
 #include "Poco/Timer.h"
+#include "Poco/Timestamp.h"
 #include "Poco/Mutex.h"
+#include "Poco/Condition.h"
 #include <list>
 #include <unordered_map>
 #include <vector>
@@ -92,10 +95,44 @@ class Data_API SessionPool
 public:
 	typedef Poco::AutoPtr<PooledSessionHolder> PooledSessionHolderPtr;
 	
-	typedef std::vector<Poco::Data::Statement> StatementCache;
+	typedef StatementLRUCache::Statements StatementCache;
 
-	typedef std::unordered_map <std::string, StatementCache> StatementCacheMap;
-	typedef std::list < std::pair < PooledSessionHolderPtr, StatementCacheMap > > SessionList;
+	struct SessionEntry : public std::pair < PooledSessionHolderPtr, StatementLRUCache >
+		/// Custom extDB Session Entry, keeps last health check + statement cache of the session.
+	{
+		SessionEntry(PooledSessionHolderPtr pHolder, std::size_t statementCacheSize, std::size_t statementCacheBytes, StatementCacheStats* pStatementStats):
+			std::pair < PooledSessionHolderPtr, StatementLRUCache >(pHolder, StatementLRUCache(statementCacheSize, statementCacheBytes, pStatementStats)),
+			pImpl(0),
+			invalidated(false),
+			validating(false)
+		{
+		}
+
+		Poco::Timestamp validated;
+		SessionImpl* pImpl;
+			/// PooledSessionImpl handed out by get(), used to find the entry of a Session.
+		bool invalidated;
+			/// Session is closed instead of put back to the idle sessions.
+		bool validating;
+			/// Idle session is being checked by background validation, checkouts skip it.
+	};
+
+	typedef std::list < SessionEntry > SessionList;
+
+	struct CheckoutStats
+		/// Custom extDB Checkout Metrics, Wait Times are in microseconds.
+	{
+		Poco::Int64 checkouts;
+		Poco::Int64 waited;
+		Poco::Int64 rejected;
+		Poco::Timestamp::TimeDiff totalWait;
+		Poco::Timestamp::TimeDiff maxWait;
+		int used;
+		int idle;
+		int allocated;
+		int capacity;
+		int waiting;
+	};
 
 	SessionPool(const std::string& sessionKey, const std::string& connectionString, int minSessions = 1, int maxSessions = 32, int idleTime = 60);
 		/// Creates the SessionPool for sessions with the given sessionKey
@@ -118,12 +155,39 @@ public:
 		/// is created. 
 		///
 		/// If the maximum number of sessions for this pool has
-		/// already been created, a SessionPoolExhaustedException
-		/// is thrown.
+		/// already been created, the caller waits up to the
+		/// checkout timeout for a session to be put back, then
+		/// a SessionPoolExhaustedException is thrown.
 
 // Custom extDB Member		
 	Session extDB_get(SessionList::iterator &itr);
-	void extDB_updateStatementCacheMap(StatementCacheMap &statement_cachemap, SessionList::iterator &itr);
+	Session extDB_get(int checkoutTimeout);
+	Session extDB_get(SessionList::iterator &itr, int checkoutTimeout);
+		/// Same as get() / extDB_get(), but waits up to checkoutTimeout
+		/// milliseconds instead of the pool checkout timeout.
+	void extDB_setCheckoutTimeout(int milliseconds);
+		/// Sets the time get() / extDB_get() waits for a session once
+		/// maxSessions are in use. Waiting callers are served in FIFO order.
+		///
+		/// If milliseconds is 0, a SessionPoolExhaustedException is
+		/// thrown straight away (default).
+	CheckoutStats extDB_getCheckoutStats() const;
+	void extDB_setStatementCacheSize(int statements);
+		/// Sets the max number of cached statements per new session, 0 = unbounded (default).
+	void extDB_setStatementCacheMemory(int kilobytes);
+		/// Sets the max approximate footprint of cached statements per new session, 0 = unbounded (default).
+	const StatementCacheStats& extDB_getStatementStats() const;
+	void extDB_startValidation(int milliseconds);
+		/// Starts background validation of idle sessions, sessions are checked
+		/// off the checkout path at least every milliseconds.
+		///
+		/// Checkouts trust idle sessions validated within milliseconds and only
+		/// check older ones. Without background validation, every checkout
+		/// checks the session it hands out.
+	void extDB_invalidate(SessionList::iterator &itr);
+	void extDB_invalidate(Session &session);
+		/// Marks a checked out session as broken (i.e. after a connection error),
+		/// it is closed instead of put back to the idle sessions.
 		
 	int capacity() const;
 		/// Returns the maximum number of sessions the SessionPool will manage.
@@ -154,12 +218,27 @@ protected:
 
 	typedef Poco::AutoPtr<PooledSessionImpl>   PooledSessionImplPtr;
 
-	
-	void purgeDeadSessions();
+
 	int deadImpl(SessionList& rSessions);
 	void putBack(PooledSessionHolderPtr pHolder);
 	void onJanitorTimer(Poco::Timer&);
 
+	struct CheckoutWaiter
+	{
+		Poco::Condition condition;
+		bool served;
+	};
+
+	SessionList::iterator checkout(int checkoutTimeout);
+		/// Moves an idle or new session to the active list, waits if the pool is full.
+		/// Must be called with _mutex locked.
+	void serveWaiters();
+		/// Reserves free slots for waiting callers in FIFO order.
+		/// Must be called with _mutex locked.
+	int freeSlots() const;
+	void onValidationTimer(Poco::Timer&);
+	void closeSession(PooledSessionHolderPtr pHolder);
+
 private:
 	SessionPool(const SessionPool&);
 	SessionPool& operator = (const SessionPool&);
@@ -172,8 +251,19 @@ private:
 	int _nSessions;
 	SessionList _idleSessions;
 	SessionList _activeSessions;
+
+	int _checkoutTimeout;
+	int _nReserved;
+	int _validationInterval;
+	int _statementCacheSize;
+	std::size_t _statementCacheBytes;
+	StatementCacheStats _statementStats;
+	std::list<CheckoutWaiter*> _waiters;
+	Poco::Condition _validationDone;
+	CheckoutStats _stats;
 	
 	Poco::Timer _janitorTimer;
+	Poco::Timer _validationTimer;
 	mutable Poco::FastMutex _mutex;
 	
 	friend class PooledSessionImpl;
@@ -134,6 +134,8 @@ public:
 	//// Custom extDB		
 	void bindClear();
 	void bindFixup();
+	void extDB_prepare();
+		/// Prepares the statement on the database without executing it.
 
 protected:
 	const AbstractExtractionVec& extractions() const;
@@ -0,0 +1,177 @@
+//
+// StatementLRUCache.h
+//
+// Library: Data
+// Package: SessionPooling
+// Module:  StatementLRUCache
+//
+// Custom extDB Class
+//
+// Definition of the StatementLRUCache class.
+//
+
+
+#ifndef Data_StatementLRUCache_INCLUDED
+#define Data_StatementLRUCache_INCLUDED
+
+
+#include "Poco/Data/Data.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Timestamp.h"
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace Poco {
+namespace Data {
+
+
+struct StatementCacheStats
+	/// Counters shared by all StatementLRUCache of a SessionPool.
+	/// Prepare Time is in microseconds.
+{
+	StatementCacheStats(): hits(0), misses(0), evictions(0), prepared(0), prepareTime(0)
+	{
+	}
+
+	std::atomic<Poco::Int64> hits;
+	std::atomic<Poco::Int64> misses;
+	std::atomic<Poco::Int64> evictions;
+	std::atomic<Poco::Int64> prepared;
+	std::atomic<Poco::Int64> prepareTime;
+};
+
+
+class StatementLRUCache
+	/// Size-bounded LRU cache of prepared statements of one session.
+	///
+	/// Entries are keyed by SQL text, an entry holds all statements of the
+	/// SQL (i.e. multiple statements of a DB_CUSTOM_V5 call).
+	/// Once more than capacity statements or more than maxBytes of approximate
+	/// footprint are cached, least recently used entries are evicted.
+	/// A capacity / maxBytes of 0 means unbounded.
+	///
+	/// The footprint of an entry is estimated from its SQL text plus a fixed
+	/// overhead per statement (statement implementation, bindings, extractions
+	/// and the server side handle), actual driver memory isn't measured.
+	///
+	/// A StatementLRUCache is only used by the thread that checked out its session.
+{
+public:
+	typedef std::vector<Poco::Data::Statement> Statements;
+
+	enum
+	{
+		STATEMENT_OVERHEAD = 2048
+			/// Approximate bytes per prepared statement on top of its SQL text.
+	};
+
+	StatementLRUCache(std::size_t capacity = 0, std::size_t maxBytes = 0, StatementCacheStats* pStats = 0):
+		_capacity(capacity),
+		_maxBytes(maxBytes),
+		_size(0),
+		_bytes(0),
+		_pStats(pStats)
+	{
+	}
+
+	static std::size_t footprint(const std::string& sql, std::size_t statements)
+		/// Returns the approximate bytes of an entry, SQL text is held by the key and the statements.
+	{
+		return (2 * sql.size()) + (statements * STATEMENT_OVERHEAD);
+	}
+
+	Statements* find(const std::string& sql)
+		/// Returns the cached statements of sql and marks them as most recently used,
+		/// or null if sql isn't cached.
+	{
+		Index::iterator it = _index.find(sql);
+		if (it == _index.end())
+		{
+			if (_pStats) ++_pStats->misses;
+			return 0;
+		}
+		if (_pStats) ++_pStats->hits;
+		_entries.splice(_entries.begin(), _entries, it->second);
+		return &(it->second->second);
+	}
+
+	bool contains(const std::string& sql) const
+		/// Returns true if sql is cached, without counting a hit or miss.
+	{
+		return _index.find(sql) != _index.end();
+	}
+
+	Statements& insert(const std::string& sql, Statements& statements, Poco::Timestamp::TimeDiff prepareTime)
+		/// Moves prepared statements into the cache, replacing any cached statements of sql.
+		/// Evicts least recently used entries if the cache is over capacity.
+	{
+		erase(sql);
+		if (_pStats)
+		{
+			_pStats->prepared += statements.size();
+			_pStats->prepareTime += prepareTime;
+		}
+
+		_entries.push_front(std::make_pair(sql, std::move(statements)));
+		_index[sql] = _entries.begin();
+		_size += _entries.front().second.size();
+		_bytes += footprint(sql, _entries.front().second.size());
+
+		while ((((_capacity > 0) && (_size > _capacity)) || ((_maxBytes > 0) && (_bytes > _maxBytes))) && (_entries.size() > 1))
+		{
+			_size -= _entries.back().second.size();
+			_bytes -= footprint(_entries.back().first, _entries.back().second.size());
+			_index.erase(_entries.back().first);
+			_entries.pop_back();
+			if (_pStats) ++_pStats->evictions;
+		}
+		return _entries.front().second;
+	}
+
+	void erase(const std::string& sql)
+	{
+		Index::iterator it = _index.find(sql);
+		if (it != _index.end())
+		{
+			_size -= it->second->second.size();
+			_bytes -= footprint(sql, it->second->second.size());
+			_entries.erase(it->second);
+			_index.erase(it);
+		}
+	}
+
+	std::size_t size() const
+		/// Returns the number of cached statements.
+	{
+		return _size;
+	}
+
+	std::size_t bytes() const
+		/// Returns the approximate footprint of cached statements in bytes.
+	{
+		return _bytes;
+	}
+
+private:
+	typedef std::list < std::pair < std::string, Statements > > Entries;
+	typedef std::unordered_map < std::string, Entries::iterator > Index;
+
+	Entries _entries;
+	Index _index;
+	std::size_t _capacity;
+	std::size_t _maxBytes;
+	std::size_t _size;
+	std::size_t _bytes;
+	StatementCacheStats* _pStats;
+};
+
+
+} } // namespace Poco::Data
+
+
+#endif // Data_StatementLRUCache_INCLUDED
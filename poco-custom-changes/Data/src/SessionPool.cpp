@@ -53,8 +53,19 @@ SessionPool::SessionPool(const std::string& sessionKey, const std::string& conne
 	_maxSessions(maxSessions),
 	_idleTime(idleTime),
 	_nSessions(0),
+	_checkoutTimeout(0),
+	_nReserved(0),
+	_validationInterval(0),
+	_statementCacheSize(0),
+	_statementCacheBytes(0),
 	_janitorTimer(1000*idleTime, 1000*idleTime/4)
 {
+	_stats.checkouts = 0;
+	_stats.waited = 0;
+	_stats.rejected = 0;
+	_stats.totalWait = 0;
+	_stats.maxWait = 0;
+
 	Poco::TimerCallback<SessionPool> callback(*this, &SessionPool::onJanitorTimer);
 	if (_idleTime > 0) _janitorTimer.start(callback);
 }
@@ -65,6 +76,7 @@ SessionPool::~SessionPool()
 	try
 	{
 		if (_idleTime > 0) _janitorTimer.stop();
+		if (_validationInterval > 0) _validationTimer.stop();
 	}
 	catch (...)
 	{
@@ -74,85 +86,229 @@ SessionPool::~SessionPool()
 
 
 Session SessionPool::get()
+{
+	return extDB_get(_checkoutTimeout);
+}
+
+
+Session SessionPool::extDB_get(int checkoutTimeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	SessionList::iterator itr = checkout(checkoutTimeout);
+	PooledSessionImplPtr pPSI(new PooledSessionImpl(itr->first));
+	itr->pImpl = pPSI.get();
+	return Session(pPSI);
+}
+
+
+Session SessionPool::extDB_get(SessionList::iterator &itr)
+{
+	return extDB_get(itr, _checkoutTimeout);
+}
+
+
+Session SessionPool::extDB_get(SessionList::iterator &itr, int checkoutTimeout)
 {
 	Poco::FastMutex::ScopedLock lock(_mutex);
-	
-	purgeDeadSessions();
 
-	if (_idleSessions.empty())
+	itr = checkout(checkoutTimeout);
+	// Session isn't wrapped in PooledSessionImpl, it only goes back to the pool via putBack(itr)
+	return Session(Poco::AutoPtr<SessionImpl>(itr->first->session(), true));
+}
+
+
+SessionPool::SessionList::iterator SessionPool::checkout(int checkoutTimeout)
+{
+	if (!_waiters.empty() || (freeSlots() <= _nReserved))
 	{
-		if (_nSessions < _maxSessions)
+		if (checkoutTimeout <= 0)
+		{
+			++_stats.rejected;
+			throw SessionPoolExhaustedException(_sessionKey, _connectionString);
+		}
+
+		Poco::Timestamp start;
+		CheckoutWaiter waiter;
+		waiter.served = false;
+		_waiters.push_back(&waiter);
+		while (!waiter.served)
+		{
+			long remaining = checkoutTimeout - (long)(start.elapsed() / 1000);
+			if (remaining <= 0) break;
+			waiter.condition.tryWait(_mutex, remaining);
+		}
+		if (!waiter.served)
+		{
+			_waiters.remove(&waiter);
+			++_stats.rejected;
+			throw SessionPoolExhaustedException(_sessionKey, _connectionString);
+		}
+		--_nReserved;
+
+		Poco::Timestamp::TimeDiff wait = start.elapsed();
+		++_stats.waited;
+		_stats.totalWait += wait;
+		if (wait > _stats.maxWait) _stats.maxWait = wait;
+	}
+
+	// Only trust Idle Sessions validated within Validation Interval, Background Validation keeps them fresh
+	//	Idle Sessions being validated still count as free slots, if only they are left wait for the validation
+	SessionList::iterator itIdle;
+	while (true)
+	{
+		bool validating = false;
+		itIdle = _idleSessions.begin();
+		while ((itIdle != _idleSessions.end()) && (*itIdle).validating)
+		{
+			validating = true;
+			++itIdle;
+		}
+		if (itIdle == _idleSessions.end())
 		{
+			if (validating && (_nSessions >= _maxSessions))
+			{
+				_validationDone.wait(_mutex);
+				continue;
+			}
+			break;
+		}
+		if (!(*itIdle).validated.isElapsed(((Poco::Timestamp::TimeDiff) _validationInterval) * 1000))
+			break;
+		if ((*itIdle).first->session()->isConnected())
+		{
+			(*itIdle).validated.update();
+			break;
+		}
+		_idleSessions.erase(itIdle);
+		--_nSessions;
+	}
+
+	if (itIdle == _idleSessions.end())
+	{
+		// Slot is taken before the lock is released, so connecting doesn't block other callers
+		++_nSessions;
+		PooledSessionHolderPtr pHolder;
+		try
+		{
+			Poco::ScopedUnlock<Poco::FastMutex> unlock(_mutex);
 			Session newSession(SessionFactory::instance().create(_sessionKey, _connectionString));
 			customizeSession(newSession);
-			PooledSessionHolderPtr pHolder(new PooledSessionHolder(*this, newSession.impl()));
-			StatementCacheMap statement_cachemap;
-			_idleSessions.push_front(std::make_pair (pHolder, std::move(statement_cachemap)));
-			++_nSessions;
+			pHolder = new PooledSessionHolder(*this, newSession.impl());
+		}
+		catch (...)
+		{
+			--_nSessions;
+			serveWaiters();
+			throw;
 		}
-		else throw SessionPoolExhaustedException(_sessionKey, _connectionString);
+		_activeSessions.push_front(SessionEntry(pHolder, _statementCacheSize, _statementCacheBytes, &_statementStats));
 	}
-	PooledSessionHolderPtr pHolder(_idleSessions.front().first);
-	PooledSessionImplPtr pPSI(new PooledSessionImpl(pHolder));
-	
-	_activeSessions.push_front(std::move(_idleSessions.front()));
-	_idleSessions.pop_front();
-	return Session(pPSI);
+	else
+	{
+		_activeSessions.push_front(std::move(*itIdle));
+		_idleSessions.erase(itIdle);
+	}
+	++_stats.checkouts;
+	return _activeSessions.begin();
 }
 
 
-Session SessionPool::extDB_get(SessionList::iterator &itr)
+void SessionPool::serveWaiters()
+{
+	while (!_waiters.empty() && (freeSlots() > _nReserved))
+	{
+		CheckoutWaiter* pWaiter = _waiters.front();
+		_waiters.pop_front();
+		pWaiter->served = true;
+		++_nReserved;
+		pWaiter->condition.signal();
+	}
+}
+
+
+int SessionPool::freeSlots() const
+{
+	return (int) _idleSessions.size() + (_maxSessions - _nSessions);
+}
+
+
+void SessionPool::extDB_setCheckoutTimeout(int milliseconds)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_checkoutTimeout = milliseconds;
+}
+
+
+void SessionPool::extDB_setStatementCacheSize(int statements)
 {
 	Poco::FastMutex::ScopedLock lock(_mutex);
+	_statementCacheSize = (statements > 0) ? statements : 0;
+}
 
-	purgeDeadSessions();
 
-	if (_idleSessions.empty())
-	{
-		Session newSession(SessionFactory::instance().create(_sessionKey, _connectionString));
-		customizeSession(newSession);
-		PooledSessionHolderPtr pHolder(new PooledSessionHolder(*this, newSession.impl()));
+void SessionPool::extDB_setStatementCacheMemory(int kilobytes)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_statementCacheBytes = (kilobytes > 0) ? ((std::size_t) kilobytes * 1024) : 0;
+}
 
-		StatementCacheMap statement_cachemap;
-		_idleSessions.push_front(std::make_pair (pHolder, std::move(statement_cachemap)));
-		++_nSessions;
-	}
-	PooledSessionHolderPtr pHolder(_idleSessions.front().first);
-	PooledSessionImplPtr pPSI(new PooledSessionImpl(pHolder));
 
+const StatementCacheStats& SessionPool::extDB_getStatementStats() const
+{
+	return _statementStats;
+}
 
-	_activeSessions.push_front(std::move(_idleSessions.front()));
-	_idleSessions.pop_front();
 
-	itr = _activeSessions.begin();
+void SessionPool::extDB_startValidation(int milliseconds)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
 
-	return Session(pPSI);
+	if ((_validationInterval > 0) || (milliseconds <= 0)) return;
+	_validationInterval = milliseconds;
+	_validationTimer.setStartInterval(milliseconds/2);
+	_validationTimer.setPeriodicInterval(milliseconds/2);
+	Poco::TimerCallback<SessionPool> callback(*this, &SessionPool::onValidationTimer);
+	_validationTimer.start(callback);
 }
 
 
-void SessionPool::extDB_updateStatementCacheMap(StatementCacheMap &statement_cachemap, SessionList::iterator &itr)
+void SessionPool::extDB_invalidate(SessionList::iterator &itr)
 {
 	Poco::FastMutex::ScopedLock lock(_mutex);
-	itr->second = statement_cachemap;
+	itr->invalidated = true;
 }
 
 
-void SessionPool::purgeDeadSessions()
+void SessionPool::extDB_invalidate(Session &session)
 {
-	SessionList::iterator it = _idleSessions.begin();
-	for (; it != _idleSessions.end(); )
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	for (SessionList::iterator it = _activeSessions.begin(); it != _activeSessions.end(); ++it)
 	{
-		if (!(*it).first->session()->isConnected())
+		if ((*it).pImpl == session.impl())
 		{
-			it = _idleSessions.erase(it);
-			// TODO
-			--_nSessions;
+			(*it).invalidated = true;
+			break;
 		}
-		else ++it;
 	}
 }
 
 
+SessionPool::CheckoutStats SessionPool::extDB_getCheckoutStats() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	CheckoutStats stats = _stats;
+	stats.used = (int) _activeSessions.size();
+	stats.idle = (int) _idleSessions.size();
+	stats.allocated = _nSessions;
+	stats.capacity = _maxSessions;
+	stats.waiting = (int) _waiters.size();
+	return stats;
+}
+
+
 int SessionPool::capacity() const
 {
 	return _maxSessions;
@@ -220,16 +376,19 @@ void SessionPool::putBack(PooledSessionHolderPtr pHolder)
 	{
 		if ((*it).first == pHolder)
 		{
-			if (pHolder->session()->isConnected())
+			if (!(*it).invalidated)
 			{
 				pHolder->access();
+				(*it).pImpl = 0;
 				_idleSessions.push_front(std::move(*it));
 			}
 			else
 			{
+				closeSession(pHolder);
 				--_nSessions;
 			};
 			_activeSessions.erase(it);
+			serveWaiters();
 			break;
 		}
 	}
@@ -240,16 +399,18 @@ void SessionPool::putBack(SessionList::iterator it)
 {
 	Poco::FastMutex::ScopedLock lock(_mutex);
 
-	if ((*it).first->session()->isConnected())
+	if (!(*it).invalidated)
 	{
 		((*it).first)->access();
 		_idleSessions.push_front(std::move(*it));
 	}
 	else
 	{
+		closeSession((*it).first);
 		--_nSessions;
 	};
 	_activeSessions.erase(it);
+	serveWaiters();
 }
 
 
@@ -260,7 +421,11 @@ void SessionPool::onJanitorTimer(Poco::Timer&)
 	SessionList::iterator it = _idleSessions.begin(); 
 	while (_nSessions > _minSessions && it != _idleSessions.end())
 	{
-		if ((*it).first->idle() > _idleTime || !(*it).first->session()->isConnected())
+		if ((*it).validating)
+		{
+			++it;
+		}
+		else if ((*it).first->idle() > _idleTime || !(*it).first->session()->isConnected())
 		{	
 			try
 			{
@@ -277,4 +442,68 @@ void SessionPool::onJanitorTimer(Poco::Timer&)
 }
 
 
+void SessionPool::onValidationTimer(Poco::Timer&)
+{
+	// Sessions are validated in place, marked Idle Sessions stay in the pool but checkouts + janitor skip them
+	std::vector<SessionList::iterator> validating;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		Poco::Timestamp::TimeDiff interval = ((Poco::Timestamp::TimeDiff) _validationInterval) * 1000 / 2;
+		for (SessionList::iterator it = _idleSessions.begin(); it != _idleSessions.end(); ++it)
+		{
+			if ((*it).validated.isElapsed(interval))
+			{
+				(*it).validating = true;
+				validating.push_back(it);
+			}
+		}
+	}
+	if (validating.empty()) return;
+
+	// Sessions are checked without holding the lock
+	std::vector<bool> connected(validating.size(), false);
+	for (std::size_t i = 0; i < validating.size(); ++i)
+	{
+		try
+		{
+			connected[i] = validating[i]->first->session()->isConnected();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	for (std::size_t i = 0; i < validating.size(); ++i)
+	{
+		if (connected[i])
+		{
+			validating[i]->validating = false;
+			validating[i]->validated.update();
+		}
+		else
+		{
+			closeSession(validating[i]->first);
+			_idleSessions.erase(validating[i]);
+			--_nSessions;
+		}
+	}
+	_validationDone.broadcast();
+	serveWaiters();
+}
+
+
+void SessionPool::closeSession(PooledSessionHolderPtr pHolder)
+{
+	try
+	{
+		pHolder->session()->close();
+	}
+	catch (...)
+	{
+	}
+}
+
+
 } } // namespace Poco::Data
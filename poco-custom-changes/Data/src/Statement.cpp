@@ -100,6 +100,11 @@ void Statement::bindFixup()
 	_ptr->fixupBinding();
 }
 
+void Statement::extDB_prepare()
+{
+	_ptr->compile();
+}
+
 
 Poco::UInt32 Statement::execute()
 {
@@ -0,0 +1,549 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "mysql_native.h"
+
+#include "../protocols/abstract_ext.h"
+
+#include <Poco/Data/DataException.h>
+#include <Poco/Data/MySQL/MySQLException.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
+#include <Poco/StringTokenizer.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/chrono.hpp>
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include <errmsg.h>
+
+
+namespace
+{
+	const unsigned int mysql_unsupported_ps = 1295;  // ER_UNSUPPORTED_PS, SQL can't be a Prepared Statement
+	const std::size_t mysql_column_buffer_size = 256;  // Bigger Values are fetched again with mysql_stmt_fetch_column
+
+	// my_bool (MySQL 5 / MariaDB) or bool (MySQL 8)
+	typedef std::remove_pointer<decltype(MYSQL_BIND().is_null)>::type mysql_bool;
+
+	inline bool isClientError(unsigned int error_code)
+	// CR_* Errors, i.e Server Gone Away / Lost Connection / Commands out of Sync, Connection can't be reused
+	{
+		return ((error_code >= 2000) && (error_code < 3000));
+	}
+
+	inline bool isStringType(enum_field_types type)
+	// Same Column Types Poco MySQL Connector returns as FDT_STRING
+	{
+		switch (type)
+		{
+			case MYSQL_TYPE_DECIMAL:
+			case MYSQL_TYPE_NEWDECIMAL:
+			case MYSQL_TYPE_STRING:
+			case MYSQL_TYPE_VAR_STRING:
+				return true;
+			default:
+				return false;
+		}
+	}
+}
+
+
+MySQLNativePool::MySQLNativePool(const std::string &connection_str, int db_max_connections, int db_checkout_timeout, int db_sync_checkout_timeout, int db_validation_interval, int db_statement_cache_size, const boost::function<void (bool)> &db_connection_status):
+	port(3306),
+	compress(false),
+	max_connections(db_max_connections),
+	checkout_timeout(db_checkout_timeout),
+	sync_checkout_timeout(db_sync_checkout_timeout),
+	validation_interval(db_validation_interval),
+	statement_cache_size(db_statement_cache_size > 0 ? db_statement_cache_size : 0),
+	connection_status(db_connection_status),
+	connections(0)
+{
+	if (max_connections < 1)
+	{
+		max_connections = 1;
+	}
+
+	// Same Connection String as Poco MySQL Connector, host=..;port=..;user=..;password=..;db=..;compress=true
+	Poco::StringTokenizer tokens(connection_str, ";", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+	for (Poco::StringTokenizer::Iterator itr = tokens.begin(); itr != tokens.end(); ++itr)
+	{
+		std::string::size_type found = itr->find('=');
+		if (found == std::string::npos)
+		{
+			continue;
+		}
+		std::string key = itr->substr(0, found);
+		std::string value = itr->substr(found + 1);
+		if (key == "host")
+		{
+			host = value;
+		}
+		else if (key == "port")
+		{
+			Poco::NumberParser::tryParseUnsigned(value, port);
+		}
+		else if (key == "user")
+		{
+			user = value;
+		}
+		else if (key == "password")
+		{
+			password = value;
+		}
+		else if (key == "db")
+		{
+			db = value;
+		}
+		else if (key == "compress")
+		{
+			compress = boost::iequals(value, "true");
+		}
+	}
+}
+
+
+MySQLNativePool::~MySQLNativePool()
+{
+	for (std::vector<Connection *>::iterator itr = idle_connections.begin(); itr != idle_connections.end(); ++itr)
+	{
+		close(*itr);
+	}
+}
+
+
+MySQLNativePool::Connection *MySQLNativePool::get()
+// Idle Connection, or opens a new one if below max_connections
+//	Waits up to checkout_timeout (sync_checkout_timeout on Arma Server Thread) once max_connections are in use, same as DB Session Pool
+//	Connection idle longer than validation_interval is pinged first, Server closed Connections (wait_timeout) are replaced
+{
+	const int timeout = SyncThread::current() ? sync_checkout_timeout : checkout_timeout;
+	while (true)
+	{
+		Connection *connection = nullptr;
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			if (idle_connections.empty() && (connections >= max_connections))
+			{
+				if ((timeout <= 0) ||
+					(!condition.wait_for(lock, boost::chrono::milliseconds(timeout), [this]{ return (!idle_connections.empty()) || (connections < max_connections); })))
+				{
+					throw Poco::Data::SessionPoolExhaustedException("MySQL", host);
+				}
+			}
+			if (!idle_connections.empty())
+			{
+				connection = idle_connections.back();
+				idle_connections.pop_back();
+			}
+			else
+			{
+				++connections;
+			}
+		}
+
+		if (connection == nullptr)
+		{
+			break;
+		}
+		if ((boost::chrono::steady_clock::now() - connection->idle_since) < boost::chrono::milliseconds(validation_interval))
+		{
+			return connection;
+		}
+		if (mysql_ping(connection->mysql) == 0)
+		{
+			return connection;
+		}
+		closeBroken(connection);
+	}
+
+	Connection *connection = new Connection();
+	connection->mysql = mysql_init(nullptr);
+	if (connection->mysql != nullptr)
+	{
+		if (compress)
+		{
+			mysql_options(connection->mysql, MYSQL_OPT_COMPRESS, nullptr);
+		}
+		if (mysql_real_connect(connection->mysql, host.c_str(), user.c_str(), password.c_str(), db.c_str(), port, nullptr, 0) != nullptr)
+		{
+			return connection;
+		}
+	}
+
+	std::string error_msg = (connection->mysql != nullptr) ? mysql_error(connection->mysql) : "mysql_init failed";
+	closeBroken(connection);
+	if (connection_status)
+	{
+		connection_status(false);
+	}
+	throw Poco::Data::MySQL::ConnectionException("Native: " + error_msg);
+}
+
+
+void MySQLNativePool::putBack(Connection *connection)
+{
+	connection->idle_since = boost::chrono::steady_clock::now();
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		idle_connections.push_back(connection);
+	}
+	condition.notify_one();
+}
+
+
+void MySQLNativePool::close(Connection *connection)
+{
+	for (StatementList::iterator itr = connection->statements.begin(); itr != connection->statements.end(); ++itr)
+	{
+		mysql_stmt_close(itr->second);
+	}
+	if (connection->mysql != nullptr)
+	{
+		mysql_close(connection->mysql);
+	}
+	delete connection;
+}
+
+
+void MySQLNativePool::closeBroken(Connection *connection)
+// Broken Connection, frees its slot so next Call opens a new Connection
+{
+	close(connection);
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		--connections;
+	}
+	condition.notify_one();
+}
+
+
+MYSQL_STMT *MySQLNativePool::prepare(Connection *connection, const std::string &sql)
+// Cached Prepared Statement for SQL, prepares + caches it if missing
+//	Returns nullptr for SQL the Server can't prepare, those are left to Poco
+{
+	std::unordered_map<std::string, StatementList::iterator>::iterator cache_itr = connection->statements_index.find(sql);
+	if (cache_itr != connection->statements_index.end())
+	{
+		connection->statements.splice(connection->statements.begin(), connection->statements, cache_itr->second);
+		return cache_itr->second->second;
+	}
+
+	MYSQL_STMT *stmt = mysql_stmt_init(connection->mysql);
+	if (stmt == nullptr)
+	{
+		throw Poco::Data::MySQL::ConnectionException("Native: mysql_stmt_init failed: " + std::string(mysql_error(connection->mysql)));
+	}
+	if (mysql_stmt_prepare(stmt, sql.c_str(), (unsigned long) sql.size()) != 0)
+	{
+		if (mysql_stmt_errno(stmt) == mysql_unsupported_ps)
+		{
+			mysql_stmt_close(stmt);
+			return nullptr;
+		}
+		try
+		{
+			throwError(stmt, sql);
+		}
+		catch (...)
+		{
+			mysql_stmt_close(stmt);
+			throw;
+		}
+	}
+
+	// Statement Cache Size 0 = No Limit, same as DB Session Statement Cache
+	connection->statements.push_front(std::make_pair(sql, stmt));
+	connection->statements_index[sql] = connection->statements.begin();
+	if ((statement_cache_size > 0) && (connection->statements.size() > statement_cache_size))
+	{
+		mysql_stmt_close(connection->statements.back().second);
+		connection->statements_index.erase(connection->statements.back().first);
+		connection->statements.pop_back();
+	}
+	return stmt;
+}
+
+
+void MySQLNativePool::throwError(MYSQL_STMT *stmt, const std::string &sql)
+{
+	const unsigned int error_code = mysql_stmt_errno(stmt);
+	const std::string error_msg = "Native: [" + Poco::NumberFormatter::format(error_code) + "]: " + mysql_stmt_error(stmt) + " SQL: " + sql;
+	if (isClientError(error_code))
+	{
+		throw Poco::Data::MySQL::ConnectionException(error_msg);
+	}
+	throw Poco::Data::MySQL::StatementException(error_msg);
+}
+
+
+template <typename Writer>
+bool MySQLNativePool::run(const std::string *sql, const std::vector<std::string> *inputs, std::size_t count, const Writer &writer, bool out_params, std::string &result, ResultStream *stream, RowInfo *row_info)
+// Runs count SQL Statements on one Connection, inputs are bound as Strings to ? Placeholders
+//	Rows of last SQL Statement are written as [1,[[...],[...]]] while they are fetched from the Server
+//	out_params = Rows of last SQL Statement (CALL) are its OUT Parameters, Result Sets of the Procedure's SELECTs are skipped
+//	Connection lost before any SQL reached the Server (Prepare / Server Gone Away on first Execute) = retried once on a new Connection
+{
+	if ((count == 0) || ((statement_cache_size > 0) && (count > statement_cache_size)))
+	{
+		// Statements would be evicted from Statement Cache while in use
+		return false;
+	}
+
+	for (int attempt = 0; ; ++attempt)
+	{
+		Connection *connection = get();
+		std::vector<MYSQL_STMT *> statements;
+		bool sent = false;  // SQL reached the Server, Call can't be retried
+		try
+		{
+			// Everything is prepared before anything runs, so SQL that isn't supported natively never runs twice
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				MYSQL_STMT *stmt = prepare(connection, sql[i]);
+				if (stmt == nullptr)
+				{
+					putBack(connection);
+					return false;
+				}
+				statements.push_back(stmt);
+			}
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				MYSQL_STMT *stmt = statements[i];
+
+				const unsigned long param_count = mysql_stmt_param_count(stmt);
+				if (param_count != inputs[i].size())
+				{
+					throw Poco::Data::MySQL::StatementException("Native: Wrong Number of Inputs, SQL: " + sql[i]);
+				}
+				if (param_count > 0)
+				{
+					std::vector<MYSQL_BIND> params(param_count);
+					std::vector<unsigned long> param_lengths(param_count);
+					std::memset(params.data(), 0, sizeof(MYSQL_BIND) * param_count);
+					for (unsigned long x = 0; x < param_count; ++x)
+					{
+						param_lengths[x] = (unsigned long) inputs[i][x].size();
+						params[x].buffer_type = MYSQL_TYPE_STRING;
+						params[x].buffer = const_cast<char *>(inputs[i][x].data());
+						params[x].buffer_length = param_lengths[x];
+						params[x].length = &param_lengths[x];
+					}
+					if (mysql_stmt_bind_param(stmt, params.data()) != 0)
+					{
+						throwError(stmt, sql[i]);
+					}
+				}
+
+				if (mysql_stmt_execute(stmt) != 0)
+				{
+					if (mysql_stmt_errno(stmt) != CR_SERVER_GONE_ERROR)
+					{
+						sent = true;
+					}
+					throwError(stmt, sql[i]);
+				}
+				sent = true;
+
+				const bool output = (i == (count - 1));
+				if (output)
+				{
+					result = "[1,[";
+				}
+
+				if (output && (row_info != nullptr))
+				{
+					row_info->affected_rows = mysql_stmt_affected_rows(stmt);
+					row_info->insert_id = mysql_stmt_insert_id(stmt);
+				}
+
+				if (output && out_params)
+				{
+					// OUT Parameters are returned after the Result Sets of the Procedure, as a Result Set flagged SERVER_PS_OUT_PARAMS
+					while ((connection->mysql->server_status & SERVER_PS_OUT_PARAMS) == 0)
+					{
+						mysql_stmt_free_result(stmt);
+						if (mysql_stmt_next_result(stmt) != 0)
+						{
+							break;
+						}
+					}
+				}
+
+				MYSQL_RES *metadata = mysql_stmt_result_metadata(stmt);
+				if (metadata != nullptr)
+				{
+					// Every Column is fetched as a String, libmysqlclient converts Binary Protocol Values
+					const unsigned int cols = mysql_num_fields(metadata);
+					MYSQL_FIELD *fields = mysql_fetch_fields(metadata);
+					std::vector<MYSQL_BIND> binds(cols);
+					std::vector< std::vector<char> > buffers(cols, std::vector<char>(mysql_column_buffer_size));
+					std::vector<unsigned long> lengths(cols);
+					std::unique_ptr<mysql_bool[]> nulls(new mysql_bool[cols]());  // Not std::vector, mysql_bool can be bool
+					std::vector<bool> string_types(cols);
+					std::memset(binds.data(), 0, sizeof(MYSQL_BIND) * cols);
+					for (unsigned int col = 0; col < cols; ++col)
+					{
+						binds[col].buffer_type = MYSQL_TYPE_STRING;
+						binds[col].buffer = buffers[col].data();
+						binds[col].buffer_length = (unsigned long) buffers[col].size();
+						binds[col].length = &lengths[col];
+						binds[col].is_null = &nulls[col];
+						string_types[col] = isStringType(fields[col].type);
+					}
+					mysql_free_result(metadata);
+					if (output && (row_info != nullptr))
+					{
+						row_info->affected_rows = 0;
+					}
+
+					if (mysql_stmt_bind_result(stmt, binds.data()) != 0)
+					{
+						throwError(stmt, sql[i]);
+					}
+
+					bool first_row = true;
+					while (true)
+					{
+						int fetch_status = mysql_stmt_fetch(stmt);
+						if (fetch_status == MYSQL_NO_DATA)
+						{
+							break;
+						}
+						else if (fetch_status == MYSQL_DATA_TRUNCATED)
+						{
+							// Grow Buffers of truncated Columns + fetch them again, bigger Buffers are kept for next Rows
+							for (unsigned int col = 0; col < cols; ++col)
+							{
+								if ((!nulls[col]) && (lengths[col] > buffers[col].size()))
+								{
+									buffers[col].resize(lengths[col]);
+									binds[col].buffer = buffers[col].data();
+									binds[col].buffer_length = (unsigned long) buffers[col].size();
+									if (mysql_stmt_fetch_column(stmt, &binds[col], col, 0) != 0)
+									{
+										throwError(stmt, sql[i]);
+									}
+								}
+							}
+							if (mysql_stmt_bind_result(stmt, binds.data()) != 0)
+							{
+								throwError(stmt, sql[i]);
+							}
+						}
+						else if (fetch_status != 0)
+						{
+							throwError(stmt, sql[i]);
+						}
+
+						if ((!output) || (cols < 1))
+						{
+							continue;
+						}
+						if (row_info != nullptr)
+						{
+							// Rows aren't buffered, mysql_stmt_affected_rows doesn't count them
+							++row_info->affected_rows;
+						}
+						if (!first_row)
+						{
+							result += ",";
+						}
+						first_row = false;
+						result += "[";
+						for (unsigned int col = 0; col < cols; ++col)
+						{
+							if (col > 0)
+							{
+								result += ",";
+							}
+							writer((std::size_t) col, buffers[col].data(), nulls[col] ? 0 : (std::size_t) lengths[col], string_types[col], result);
+						}
+						result += "]";
+						if ((stream != nullptr) && stream->ready(result))
+						{
+							stream->publish(result);
+						}
+					}
+				}
+				if (output)
+				{
+					result += "]]";
+				}
+
+				// CALL returns an extra Status Result
+				mysql_stmt_free_result(stmt);
+				while (mysql_stmt_next_result(stmt) == 0)
+				{
+					mysql_stmt_free_result(stmt);
+				}
+			}
+		}
+		catch (Poco::Data::MySQL::ConnectionException&)
+		{
+			closeBroken(connection);
+			if ((attempt == 0) && (!sent))
+			{
+				continue;
+			}
+			if (connection_status)
+			{
+				connection_status(false);
+			}
+			throw;
+		}
+		catch (...)
+		{
+			for (std::vector<MYSQL_STMT *>::iterator itr = statements.begin(); itr != statements.end(); ++itr)
+			{
+				mysql_stmt_free_result(*itr);
+				mysql_stmt_reset(*itr);
+			}
+			putBack(connection);
+			throw;
+		}
+		putBack(connection);
+		if (connection_status)
+		{
+			connection_status(true);
+		}
+		return true;
+	}
+}
+
+
+bool MySQLNativePool::execute(const std::string &sql, const std::vector<std::string> &inputs, int options, std::string &result, ResultStream *stream)
+{
+	return run(&sql, &inputs, 1, OptionsWriter(options), ((options & OUT_PARAMS) != 0), result, stream, nullptr);
+}
+
+
+bool MySQLNativePool::execute(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs, const ValueWriter &writer, std::string &result, ResultStream *stream, RowInfo *row_info)
+{
+	if (inputs.size() < sql.size())
+	{
+		return false;
+	}
+	return run(sql.data(), inputs.data(), sql.size(), writer, false, result, stream, row_info);
+}
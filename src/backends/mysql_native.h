@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "native_pool.h"
+
+#include <boost/chrono.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mysql.h>
+
+
+class MySQLNativePool: public NativePool
+// Native libmysqlclient Connections, SQL runs as Server Side Prepared Statements (Binary Protocol)
+//	Rows are fetched one at a time with mysql_stmt_fetch (no mysql_stmt_store_result), so a Result Set is never buffered
+//	Each Connection keeps its own Prepared Statement Cache, Broken Connections are closed instead of being put back
+//	Idle Connections are pinged at Checkout after Validation Interval, Call is retried once on a new Connection if its SQL never reached the Server
+{
+	public:
+		// connection_status is called with false on Connection Failures + true after a Call succeeded, i.e for the Circuit Breaker
+		MySQLNativePool(const std::string &connection_str, int max_connections, int checkout_timeout, int sync_checkout_timeout, int validation_interval, int statement_cache_size, const boost::function<void (bool)> &connection_status);
+		~MySQLNativePool();
+
+		bool execute(const std::string &sql, const std::vector<std::string> &inputs, int options, std::string &result, ResultStream *stream);
+		bool execute(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs, const ValueWriter &writer, std::string &result, ResultStream *stream, RowInfo *row_info);
+
+	private:
+		typedef std::list<std::pair<std::string, MYSQL_STMT *> > StatementList;
+
+		struct Connection {
+			MYSQL *mysql;
+			boost::chrono::steady_clock::time_point idle_since;
+			StatementList statements;  // Most recently used first
+			std::unordered_map<std::string, StatementList::iterator> statements_index;
+		};
+
+		Connection *get();
+		void putBack(Connection *connection);
+		void close(Connection *connection);
+		void closeBroken(Connection *connection);
+
+		MYSQL_STMT *prepare(Connection *connection, const std::string &sql);
+		template <typename Writer> bool run(const std::string *sql, const std::vector<std::string> *inputs, std::size_t count, const Writer &writer, bool out_params, std::string &result, ResultStream *stream, RowInfo *row_info);
+		void throwError(MYSQL_STMT *stmt, const std::string &sql);
+
+		std::string host;
+		unsigned int port;
+		std::string user;
+		std::string password;
+		std::string db;
+		bool compress;
+
+		int max_connections;
+		int checkout_timeout;
+		int sync_checkout_timeout;  // Arma Server Thread (0: Sync Calls)
+		int validation_interval;  // Milliseconds, 0 = Ping on every Checkout
+		std::size_t statement_cache_size;
+		boost::function<void (bool)> connection_status;
+
+		boost::mutex mutex;
+		boost::condition_variable condition;
+		std::vector<Connection *> idle_connections;
+		int connections;
+};
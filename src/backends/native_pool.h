@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <boost/function.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+class ResultStream;
+
+
+class NativePool
+// Native Database Backend, skips Poco::Data Statement Binding / Extraction + RecordSet
+//	Rows are written straight into the Result String as they are fetched
+//	Errors are thrown as the same Poco::Data Exceptions the Poco Connector throws
+{
+	public:
+		enum Options {
+			QUOTE_STRINGS = 1,  // String Values are wrapped in Quotes
+			QUOTE_EMPTY = 2,    // Empty + NULL Values are returned as ""
+			OUT_PARAMS = 4      // CALL Rows are its OUT Parameters, other Result Sets are skipped (MySQL only)
+		};
+
+		// Writes one Value to result, NULL is passed as an empty Value
+		typedef boost::function<void (std::size_t col, const char *value, std::size_t value_size, bool string_type, std::string &result)> ValueWriter;
+
+		// DB_RAW Value Output, same as the Poco Path
+		struct OptionsWriter {
+			explicit OptionsWriter(int writer_options) : options(writer_options) {}
+			void operator()(std::size_t col, const char *value, std::size_t value_size, bool string_type, std::string &result) const
+			{
+				if (value_size == 0)
+				{
+					if (options & QUOTE_EMPTY)
+					{
+						result += "\"\"";
+					}
+				}
+				else if ((options & QUOTE_STRINGS) && string_type)
+				{
+					result += "\"";
+					result.append(value, value_size);
+					result += "\"";
+				}
+				else
+				{
+					result.append(value, value_size);
+				}
+			}
+			int options;
+		};
+
+		// Affected Rows + Last Insert ID of last SQL Statement, read from the same Connection it ran on
+		//	Affected Rows = Rows fetched for SQL that returns Rows
+		struct RowInfo {
+			unsigned long long affected_rows = 0;
+			unsigned long long insert_id = 0;
+		};
+
+		virtual ~NativePool() {}
+
+		// DB_RAW -- Runs sql, Rows as [1,[[...],[...]]] formatted by Options
+		//	false = SQL not supported natively, use Poco
+		//	stream (optional) = Rows are published as they are fetched
+		virtual bool execute(const std::string &sql, const std::vector<std::string> &inputs, int options, std::string &result, ResultStream *stream) = 0;
+
+		// DB_CUSTOM -- Runs every sql on one Connection, Rows of last sql as [1,[[...],[...]]] formatted by writer
+		//	row_info (optional) = Affected Rows + Last Insert ID of last sql
+		virtual bool execute(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs, const ValueWriter &writer, std::string &result, ResultStream *stream, RowInfo *row_info) = 0;
+};
@@ -0,0 +1,311 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "sqlite_native.h"
+
+#include "../protocols/abstract_ext.h"
+
+#include <Poco/Data/DataException.h>
+#include <Poco/Data/SQLite/SQLiteException.h>
+
+#include <boost/chrono.hpp>
+
+#include <cctype>
+
+#include <sqlite3.h>
+
+
+SQLiteNativePool::SQLiteNativePool(const std::string &db_path, int db_max_connections, int db_checkout_timeout, int db_sync_checkout_timeout, int db_statement_cache_size, const std::vector<std::string> &db_session_statements):
+	path(db_path),
+	max_connections(db_max_connections),
+	checkout_timeout(db_checkout_timeout),
+	sync_checkout_timeout(db_sync_checkout_timeout),
+	statement_cache_size(db_statement_cache_size > 0 ? db_statement_cache_size : 0),
+	session_statements(db_session_statements),
+	connections(0)
+{
+	if (max_connections < 1)
+	{
+		max_connections = 1;
+	}
+}
+
+
+SQLiteNativePool::~SQLiteNativePool()
+{
+	for (std::vector<Connection *>::iterator itr = idle_connections.begin(); itr != idle_connections.end(); ++itr)
+	{
+		close(*itr);
+	}
+}
+
+
+SQLiteNativePool::Connection *SQLiteNativePool::get()
+// Idle Connection, or opens a new one if below max_connections
+//	Waits up to checkout_timeout (sync_checkout_timeout on Arma Server Thread) once max_connections are in use, same as DB Session Pool
+{
+	const int timeout = SyncThread::current() ? sync_checkout_timeout : checkout_timeout;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		if (idle_connections.empty() && (connections >= max_connections))
+		{
+			if ((timeout <= 0) ||
+				(!condition.wait_for(lock, boost::chrono::milliseconds(timeout), [this]{ return (!idle_connections.empty()) || (connections < max_connections); })))
+			{
+				throw Poco::Data::SessionPoolExhaustedException("SQLite", path);
+			}
+		}
+		if (!idle_connections.empty())
+		{
+			Connection *connection = idle_connections.back();
+			idle_connections.pop_back();
+			return connection;
+		}
+		++connections;
+	}
+
+	Connection *connection = new Connection();
+	connection->db = nullptr;
+	int error_code = sqlite3_open_v2(path.c_str(), &connection->db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr);
+	if (error_code == SQLITE_OK)
+	{
+		// Busy Handler instead of Poco maxRetryAttempts, waits on Database Locks up to Checkout Timeout
+		sqlite3_busy_timeout(connection->db, checkout_timeout);
+		for (std::vector<std::string>::const_iterator itr = session_statements.begin(); itr != session_statements.end(); ++itr)
+		{
+			error_code = sqlite3_exec(connection->db, itr->c_str(), nullptr, nullptr, nullptr);
+			if (error_code != SQLITE_OK)
+			{
+				break;
+			}
+		}
+	}
+	if (error_code != SQLITE_OK)
+	{
+		std::string error_msg = (connection->db != nullptr) ? sqlite3_errmsg(connection->db) : sqlite3_errstr(error_code);
+		close(connection);
+		{
+			boost::lock_guard<boost::mutex> lock(mutex);
+			--connections;
+		}
+		condition.notify_one();
+		throw Poco::Data::ConnectionFailedException(error_msg, path);
+	}
+	return connection;
+}
+
+
+void SQLiteNativePool::putBack(Connection *connection)
+{
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		idle_connections.push_back(connection);
+	}
+	condition.notify_one();
+}
+
+
+void SQLiteNativePool::close(Connection *connection)
+{
+	for (StatementList::iterator itr = connection->statements.begin(); itr != connection->statements.end(); ++itr)
+	{
+		sqlite3_finalize(itr->second);
+	}
+	sqlite3_close(connection->db);
+	delete connection;
+}
+
+
+sqlite3_stmt *SQLiteNativePool::prepare(Connection *connection, const std::string &sql)
+// Cached Prepared Statement for SQL, prepares + caches it if missing
+//	Returns nullptr for SQL with more than one Statement, those are left to Poco
+{
+	std::unordered_map<std::string, StatementList::iterator>::iterator cache_itr = connection->statements_index.find(sql);
+	if (cache_itr != connection->statements_index.end())
+	{
+		connection->statements.splice(connection->statements.begin(), connection->statements, cache_itr->second);
+		return cache_itr->second->second;
+	}
+
+	sqlite3_stmt *stmt = nullptr;
+	const char *tail = nullptr;
+	int error_code = sqlite3_prepare_v2(connection->db, sql.c_str(), (int) sql.size(), &stmt, &tail);
+	if (error_code != SQLITE_OK)
+	{
+		throwError(connection->db, error_code, sql);
+	}
+	if (stmt == nullptr)
+	{
+		// Empty SQL
+		return nullptr;
+	}
+	for (; (tail != nullptr) && (*tail != '\0'); ++tail)
+	{
+		if ((!std::isspace((unsigned char) *tail)) && (*tail != ';'))
+		{
+			sqlite3_finalize(stmt);
+			return nullptr;
+		}
+	}
+
+	// Statement Cache Size 0 = No Limit, same as DB Session Statement Cache
+	connection->statements.push_front(std::make_pair(sql, stmt));
+	connection->statements_index[sql] = connection->statements.begin();
+	if ((statement_cache_size > 0) && (connection->statements.size() > statement_cache_size))
+	{
+		sqlite3_finalize(connection->statements.back().second);
+		connection->statements_index.erase(connection->statements.back().first);
+		connection->statements.pop_back();
+	}
+	return stmt;
+}
+
+
+void SQLiteNativePool::throwError(sqlite3 *db, int error_code, const std::string &sql)
+{
+	switch (error_code & 0xFF)
+	{
+		case SQLITE_BUSY:
+		case SQLITE_LOCKED:
+			throw Poco::Data::SQLite::DBLockedException(sqlite3_errmsg(db), sql);
+		default:
+			throw Poco::Data::SQLite::SQLiteException(sqlite3_errmsg(db), sql);
+	}
+}
+
+
+template <typename Writer>
+bool SQLiteNativePool::run(const std::string *sql, const std::vector<std::string> *inputs, std::size_t count, const Writer &writer, std::string &result, ResultStream *stream, RowInfo *row_info)
+// Runs count SQL Statements on one Connection, inputs are bound as TEXT to ? Placeholders
+//	Rows of last SQL Statement are written as [1,[[...],[...]]], TEXT Values are string_type
+{
+	if ((count == 0) || ((statement_cache_size > 0) && (count > statement_cache_size)))
+	{
+		// Statements would be evicted from Statement Cache while in use
+		return false;
+	}
+
+	Connection *connection = get();
+	std::vector<sqlite3_stmt *> statements;
+	try
+	{
+		// Everything is prepared before anything runs, so SQL that isn't supported natively never runs twice
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			sqlite3_stmt *stmt = prepare(connection, sql[i]);
+			if (stmt == nullptr)
+			{
+				putBack(connection);
+				return false;
+			}
+			statements.push_back(stmt);
+		}
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			sqlite3_stmt *stmt = statements[i];
+			for (std::vector<std::string>::size_type x = 0; x < inputs[i].size(); ++x)
+			{
+				sqlite3_bind_text(stmt, (int) (x + 1), inputs[i][x].c_str(), (int) inputs[i][x].size(), SQLITE_TRANSIENT);
+			}
+
+			const bool output = (i == (count - 1));
+			if (output)
+			{
+				result = "[1,[";
+			}
+			const int cols = sqlite3_column_count(stmt);
+			bool first_row = true;
+			unsigned long long rows = 0;
+			int error_code;
+			while ((error_code = sqlite3_step(stmt)) == SQLITE_ROW)
+			{
+				if ((!output) || (cols < 1))
+				{
+					continue;
+				}
+				++rows;
+				if (!first_row)
+				{
+					result += ",";
+				}
+				first_row = false;
+				result += "[";
+				for (int col = 0; col < cols; ++col)
+				{
+					if (col > 0)
+					{
+						result += ",";
+					}
+					const char *value = reinterpret_cast<const char *>(sqlite3_column_text(stmt, col));
+					const int value_size = sqlite3_column_bytes(stmt, col);
+					writer((std::size_t) col, value, (value != nullptr) ? (std::size_t) value_size : 0, (sqlite3_column_type(stmt, col) == SQLITE_TEXT), result);
+				}
+				result += "]";
+				if ((stream != nullptr) && stream->ready(result))
+				{
+					stream->publish(result);
+				}
+			}
+			if (error_code != SQLITE_DONE)
+			{
+				throwError(connection->db, error_code, sql[i]);
+			}
+			if (output)
+			{
+				result += "]]";
+				if (row_info != nullptr)
+				{
+					// sqlite3_changes keeps the count of the last INSERT / UPDATE / DELETE, so only used for SQL without Rows
+					row_info->affected_rows = (cols > 0) ? rows : (unsigned long long) sqlite3_changes(connection->db);
+					row_info->insert_id = (unsigned long long) sqlite3_last_insert_rowid(connection->db);
+				}
+			}
+			sqlite3_reset(stmt);
+			sqlite3_clear_bindings(stmt);
+		}
+	}
+	catch (...)
+	{
+		for (std::vector<sqlite3_stmt *>::iterator itr = statements.begin(); itr != statements.end(); ++itr)
+		{
+			sqlite3_reset(*itr);
+			sqlite3_clear_bindings(*itr);
+		}
+		putBack(connection);
+		throw;
+	}
+	putBack(connection);
+	return true;
+}
+
+
+bool SQLiteNativePool::execute(const std::string &sql, const std::vector<std::string> &inputs, int options, std::string &result, ResultStream *stream)
+{
+	return run(&sql, &inputs, 1, OptionsWriter(options), result, stream, nullptr);
+}
+
+
+bool SQLiteNativePool::execute(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs, const ValueWriter &writer, std::string &result, ResultStream *stream, RowInfo *row_info)
+{
+	if (inputs.size() < sql.size())
+	{
+		return false;
+	}
+	return run(sql.data(), inputs.data(), sql.size(), writer, result, stream, row_info);
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "native_pool.h"
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+
+class SQLiteNativePool: public NativePool
+// Native sqlite3 Connections, each Connection keeps its own Prepared Statement Cache
+{
+	public:
+		SQLiteNativePool(const std::string &path, int max_connections, int checkout_timeout, int sync_checkout_timeout, int statement_cache_size, const std::vector<std::string> &session_statements);
+		~SQLiteNativePool();
+
+		bool execute(const std::string &sql, const std::vector<std::string> &inputs, int options, std::string &result, ResultStream *stream);
+		bool execute(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs, const ValueWriter &writer, std::string &result, ResultStream *stream, RowInfo *row_info);
+
+	private:
+		typedef std::list<std::pair<std::string, sqlite3_stmt *> > StatementList;
+
+		struct Connection {
+			sqlite3 *db;
+			StatementList statements;  // Most recently used first
+			std::unordered_map<std::string, StatementList::iterator> statements_index;
+		};
+
+		Connection *get();
+		void putBack(Connection *connection);
+		void close(Connection *connection);
+
+		sqlite3_stmt *prepare(Connection *connection, const std::string &sql);
+		template <typename Writer> bool run(const std::string *sql, const std::vector<std::string> *inputs, std::size_t count, const Writer &writer, std::string &result, ResultStream *stream, RowInfo *row_info);
+		void throwError(sqlite3 *db, int error_code, const std::string &sql);
+
+		std::string path;
+		int max_connections;
+		int checkout_timeout;
+		int sync_checkout_timeout;  // Arma Server Thread (0: Sync Calls)
+		std::size_t statement_cache_size;
+		std::vector<std::string> session_statements;
+
+		boost::mutex mutex;
+		boost::condition_variable condition;
+		std::vector<Connection *> idle_connections;
+		int connections;
+};
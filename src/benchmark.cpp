@@ -0,0 +1,326 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// SQLite Benchmark -- Mixed Read / Write Load from Worker Threads
+//	Default = Read/Write DB Sessions, Rollback Journal + maxRetryAttempts (extDB SQLite Default)
+//	Tuned   = WAL + 1 Writer DB Session + Read Only DB Sessions (SQLite Readers Option)
+//
+//	extDB-benchmark [threads] [seconds] [write percent]
+//
+// SQLite Benchmark -- DB_RAW SELECT of every Row, Poco::Data RecordSet vs Native sqlite3 Backend (NATIVE_SQLITE Builds)
+//	extDB-benchmark select [iterations]
+
+
+#ifdef BENCHMARK_APP
+
+#include <Poco/Data/Common.h>
+#include <Poco/Data/MetaColumn.h>
+#include <Poco/Data/RecordSet.h>
+#include <Poco/Data/Session.h>
+#include <Poco/Data/SessionPool.h>
+#include <Poco/Data/SQLite/Connector.h>
+#include <Poco/Data/SQLite/SQLiteException.h>
+#include <Poco/Exception.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
+#include <Poco/Timestamp.h>
+
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef NATIVE_SQLITE
+	#include "backends/sqlite_native.h"
+#endif
+
+
+namespace
+{
+	const int benchmark_rows = 10000;
+
+	class BenchmarkPool : public Poco::Data::SessionPool
+	{
+		public:
+			BenchmarkPool(const std::string &connection_str, int sessions, const std::vector<std::string> &statements):
+				Poco::Data::SessionPool("SQLite", connection_str, 1, sessions, 60),
+				session_statements(statements)
+			{
+				extDB_setCheckoutTimeout(60000);
+			}
+
+		protected:
+			void customizeSession(Poco::Data::Session &session)
+			{
+				session.setProperty("maxRetryAttempts", 100);
+				for (std::vector<std::string>::const_iterator itr = session_statements.begin(); itr != session_statements.end(); ++itr)
+				{
+					session << *itr, Poco::Data::now;
+				}
+			}
+
+		private:
+			std::vector<std::string> session_statements;
+	};
+
+	struct Results
+	{
+		Results() : reads(0), writes(0), errors(0), locked(0), max_latency(0), total_latency(0) {}
+		std::atomic<long long> reads;
+		std::atomic<long long> writes;
+		std::atomic<long long> errors;
+		std::atomic<long long> locked;
+		std::atomic<long long> max_latency;
+		std::atomic<long long> total_latency;
+	};
+
+	void worker(Poco::Data::SessionPool *writer, Poco::Data::SessionPool *reader, int write_percent, int seconds, unsigned int seed, Results *results)
+	{
+		boost::random::mt19937 gen(seed);
+		boost::random::uniform_int_distribution<> percent_dist(1, 100);
+		boost::random::uniform_int_distribution<> uid_dist(1, benchmark_rows);
+
+		Poco::Timestamp start;
+		while (!start.isElapsed(((Poco::Timestamp::TimeDiff) seconds) * 1000000))
+		{
+			int uid = uid_dist(gen);
+			bool write = (percent_dist(gen) <= write_percent);
+			Poco::Timestamp op_start;
+			try
+			{
+				if (write)
+				{
+					Poco::Data::Session session = writer->get();
+					session << "UPDATE player SET money = money + 1 WHERE uid = ?", Poco::Data::use(uid), Poco::Data::now;
+					++results->writes;
+				}
+				else
+				{
+					int money = 0;
+					Poco::Data::Session session = reader->get();
+					session << "SELECT money FROM player WHERE uid = ?", Poco::Data::use(uid), Poco::Data::into(money), Poco::Data::now;
+					++results->reads;
+				}
+			}
+			catch (Poco::Data::SQLite::DBLockedException &)
+			{
+				++results->locked;
+			}
+			catch (Poco::Exception &)
+			{
+				++results->errors;
+			}
+			long long latency = op_start.elapsed();
+			results->total_latency += latency;
+			long long max_latency = results->max_latency.load();
+			while ((latency > max_latency) && (!results->max_latency.compare_exchange_weak(max_latency, latency)))
+			{
+			}
+		}
+	}
+
+	void setupDatabase(const std::string &path)
+	{
+		boost::filesystem::remove(path);
+		boost::filesystem::remove(path + "-wal");
+		boost::filesystem::remove(path + "-shm");
+
+		Poco::Data::Session session("SQLite", path);
+		session << "CREATE TABLE player (uid INTEGER PRIMARY KEY, name TEXT, money INTEGER)", Poco::Data::now;
+		session.begin();
+		for (int uid = 1; uid <= benchmark_rows; ++uid)
+		{
+			std::string name = "Player" + Poco::NumberFormatter::format(uid);
+			session << "INSERT INTO player (uid, name, money) VALUES (?, ?, 0)", Poco::Data::use(uid), Poco::Data::use(name), Poco::Data::now;
+		}
+		session.commit();
+	}
+
+	void runBenchmark(const std::string &name, Poco::Data::SessionPool &writer, Poco::Data::SessionPool &reader, int threads, int seconds, int write_percent)
+	{
+		Results results;
+		boost::thread_group thread_group;
+		for (int i = 0; i < threads; ++i)
+		{
+			thread_group.create_thread(boost::bind(&worker, &writer, &reader, write_percent, seconds, (unsigned int) (i + 1), &results));
+		}
+		thread_group.join_all();
+
+		long long ops = results.reads + results.writes;
+		long long attempts = ops + results.errors + results.locked;
+		std::cout << std::left << std::setw(10) << name
+			<< " Reads/s: " << std::setw(10) << (results.reads / seconds)
+			<< " Writes/s: " << std::setw(10) << (results.writes / seconds)
+			<< " Locked: " << std::setw(8) << results.locked
+			<< " Errors: " << std::setw(8) << results.errors
+			<< " Avg us: " << std::setw(8) << (attempts > 0 ? (results.total_latency / attempts) : 0)
+			<< " Max us: " << results.max_latency << std::endl;
+	}
+
+	void pocoSelect(Poco::Data::Session &session, const std::string &input_str, std::string &result)
+	// Same Poco Path + Output as DB_RAW_V2
+	{
+		Poco::Data::Statement sql(session);
+		sql << input_str;
+		sql.execute();
+		Poco::Data::RecordSet rs(sql);
+
+		result = "[1,[";
+		std::size_t cols = rs.columnCount();
+		if (cols >= 1)
+		{
+			bool more = rs.moveFirst();
+			while (more)
+			{
+				result += "[";
+				for (std::size_t col = 0; col < cols; ++col)
+				{
+					std::string temp_str = rs[col].convert<std::string>();
+					if (temp_str.empty())
+					{
+						result += "\"\"";
+					}
+					else if (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING)
+					{
+						result += "\"" + temp_str + "\"";
+					}
+					else
+					{
+						result += temp_str;
+					}
+					if (col < (cols - 1))
+					{
+						result += ",";
+					}
+				}
+				more = rs.moveNext();
+				result += more ? "]," : "]";
+			}
+		}
+		result += "]]";
+	}
+
+	void printSelect(const std::string &name, int iterations, Poco::Timestamp::TimeDiff elapsed, const std::string &result)
+	{
+		std::cout << std::left << std::setw(10) << name
+			<< " Avg ms: " << std::setw(10) << (elapsed / iterations / 1000.0)
+			<< " Rows/s: " << std::setw(12) << (long long) (((double) benchmark_rows) * iterations * 1000000 / (elapsed > 0 ? elapsed : 1))
+			<< " Result bytes: " << result.size() << std::endl;
+	}
+
+	void runSelectBenchmark(const std::string &path, int iterations)
+	{
+		const std::string select_sql = "SELECT uid, name, money FROM player";
+		setupDatabase(path);
+
+		std::string poco_result;
+		{
+			Poco::Data::Session session("SQLite", path);
+			pocoSelect(session, select_sql, poco_result);
+			Poco::Timestamp start;
+			for (int i = 0; i < iterations; ++i)
+			{
+				pocoSelect(session, select_sql, poco_result);
+			}
+			printSelect("Poco", iterations, start.elapsed(), poco_result);
+		}
+
+		#ifdef NATIVE_SQLITE
+			std::string native_result;
+			SQLiteNativePool pool(path, 1, 60000, 256, std::vector<std::string>());
+			pool.execute(select_sql, std::vector<std::string>(), SQLiteNativePool::QUOTE_STRINGS | SQLiteNativePool::QUOTE_EMPTY, native_result, nullptr);
+			Poco::Timestamp start;
+			for (int i = 0; i < iterations; ++i)
+			{
+				pool.execute(select_sql, std::vector<std::string>(), SQLiteNativePool::QUOTE_STRINGS | SQLiteNativePool::QUOTE_EMPTY, native_result, nullptr);
+			}
+			printSelect("Native", iterations, start.elapsed(), native_result);
+			if (native_result != poco_result)
+			{
+				std::cout << "extDB: Native Result differs from Poco Result" << std::endl;
+			}
+		#else
+			std::cout << "Native     Not compiled in, build with NATIVE_SQLITE" << std::endl;
+		#endif
+	}
+}
+
+
+int main(int nNumberofArgs, char* pszArgs[])
+{
+	if ((nNumberofArgs > 1) && (std::string(pszArgs[1]) == "select"))
+	{
+		int iterations = 50;
+		if (nNumberofArgs > 2) Poco::NumberParser::tryParse(pszArgs[2], iterations);
+		if (iterations < 1) iterations = 1;
+
+		Poco::Data::SQLite::Connector::registerConnector();
+		const std::string path = "extdb-benchmark.db";
+		std::cout << "extDB: SQLite SELECT Benchmark: Rows: " << benchmark_rows << " Iterations: " << iterations << std::endl;
+		runSelectBenchmark(path, iterations);
+		boost::filesystem::remove(path);
+		return 0;
+	}
+
+	int threads = 8;
+	int seconds = 10;
+	int write_percent = 20;
+	if (nNumberofArgs > 1) Poco::NumberParser::tryParse(pszArgs[1], threads);
+	if (nNumberofArgs > 2) Poco::NumberParser::tryParse(pszArgs[2], seconds);
+	if (nNumberofArgs > 3) Poco::NumberParser::tryParse(pszArgs[3], write_percent);
+
+	Poco::Data::SQLite::Connector::registerConnector();
+	const std::string path = "extdb-benchmark.db";
+
+	std::cout << "extDB: SQLite Benchmark: Threads: " << threads << " Seconds: " << seconds << " Write %: " << write_percent << std::endl;
+
+	{
+		// extDB SQLite Default
+		setupDatabase(path);
+		BenchmarkPool pool(path, threads + 1, std::vector<std::string>());
+		runBenchmark("Default", pool, pool, threads, seconds, write_percent);
+	}
+	{
+		// WAL + 1 Writer + Readers
+		setupDatabase(path);
+		std::vector<std::string> statements;
+		statements.push_back("PRAGMA journal_mode=WAL");
+		statements.push_back("PRAGMA synchronous=NORMAL");
+		statements.push_back("PRAGMA mmap_size=268435456");
+		BenchmarkPool writer(path, 1, statements);
+		statements.push_back("PRAGMA query_only=1");
+		BenchmarkPool reader(path, threads + 1, statements);
+		runBenchmark("Tuned", writer, reader, threads, seconds, write_percent);
+	}
+
+	boost::filesystem::remove(path);
+	boost::filesystem::remove(path + "-wal");
+	boost::filesystem::remove(path + "-shm");
+	return 0;
+}
+
+#endif
@@ -17,6 +17,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include "ext.h"
 
+#include <Poco/Data/RecordSet.h>
 #include <Poco/Data/Session.h>
 #include <Poco/Data/SessionPool.h>
 
@@ -37,7 +38,9 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
+#include <boost/chrono.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/random/random_device.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
@@ -51,23 +54,32 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 #ifdef TEST_APP
 	#include <iostream>
 #endif
 
+#ifdef NATIVE_MYSQL
+	#include "backends/mysql_native.h"
+#endif
+#ifdef NATIVE_SQLITE
+	#include "backends/sqlite_native.h"
+#endif
 #include "uniqueid.h"
 #include "protocols/abstract_protocol.h"
 #include "protocols/db_custom_v3.h"
 #include "protocols/db_custom_v5.h"
 #include "protocols/db_procedure_v2.h"
-#include "protocols/db_raw_v2.h"
-#include "protocols/db_raw_no_extra_quotes_v2.h"
+#include "protocols/db_raw_v3.h"
 #include "protocols/log.h"
 #include "protocols/misc.h"
 
 
+boost::thread_specific_ptr<bool> SyncThread::sync_thread;
+
+
 void DBPool::customizeSession (Poco::Data::Session& session)
 {
 	try
@@ -79,6 +91,10 @@ void DBPool::customizeSession (Poco::Data::Session& session)
 	catch (Poco::Data::NotSupportedException&)
 	{
 	}
+	for (std::vector<std::string>::const_iterator itr = session_statements.begin(); itr != session_statements.end(); ++itr)
+	{
+		session << *itr, Poco::Data::now;
+	}
 }
 
 
@@ -86,6 +102,21 @@ Ext::Ext(std::string dll_path) {
 	mgr.reset (new IdManager);
 	extDB_lock = false;
 	extDB_error_db_kill_server = true;
+	sync_latency_budget = 0;
+	sync_hard_timeout = 0;
+	stream_chunk_size = 8192;
+	stream_buffer_size = 1048576;
+	stream_timeout = 30000;
+	cursor_page_size = 100;
+	cursor_idle_timeout = 60000;
+	max_cursors = 8;
+	last_cursor_id = 0;
+
+	default_database = nullptr;
+
+	boost::shared_ptr<const ProtocolRegistry> empty_registry(new ProtocolRegistry());
+	protocol_registry_snapshots.push_back(empty_registry);
+	protocol_registry.store(empty_registry.get());
 
 	bool conf_found = false;
 	bool conf_randomized = false;
@@ -198,6 +229,22 @@ Ext::Ext(std::string dll_path) {
 
 		steam_api_key = pConf->getString("Main.Steam_WEB_API_KEY", "");
 
+		// Sync Calls, Max Time (milliseconds) to block Game Thread
+		sync_latency_budget = pConf->getInt("Main.Sync Latency Budget", 0);
+		sync_hard_timeout = pConf->getInt("Main.Sync Hard Timeout", 0);
+
+		// Streamed Results (6:), Rows are published every Stream Chunk Size (bytes)
+		//   Call waits while Client has Stream Buffer Size (bytes) left to fetch, gives up after Stream Timeout (milliseconds)
+		stream_chunk_size = std::max(pConf->getInt("Main.Stream Chunk Size", 8192), 1);
+		stream_buffer_size = std::max(pConf->getInt("Main.Stream Buffer Size", 1048576), 1);
+		stream_timeout = pConf->getInt("Main.Stream Timeout", 30000);
+
+		// Cursors (7: / 8:), Rows per Page + Time (milliseconds) an unused Cursor is kept open
+		//   Max Cursors open at once, each holds a DB Session so Calls aren't starved of DB Sessions, 0 = No Limit
+		cursor_page_size = std::max(pConf->getInt("Main.Cursor Page Size", 100), 1);
+		cursor_idle_timeout = std::max(pConf->getInt("Main.Cursor Idle Timeout", 60000), 1000);
+		max_cursors = std::max(pConf->getInt("Main.Max Cursors", 8), 0);
+
 		// Start Threads + ASIO
 		max_threads = pConf->getInt("Main.Threads", 0);
 		if (max_threads <= 0)
@@ -214,6 +261,11 @@ Ext::Ext(std::string dll_path) {
 			BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Creating Worker Thread +1";
 		}
 
+		// Cursor Timer, checks for idle Cursors every half Cursor Idle Timeout
+		cursor_timer.reset(new boost::asio::deadline_timer(io_service));
+		cursor_timer->expires_from_now(boost::posix_time::milliseconds(cursor_idle_timeout / 2));
+		cursor_timer->async_wait(boost::bind(&Ext::onCursorTimer, this, boost::asio::placeholders::error));
+
 		// Load Logging Filter Options
 		#ifdef TESTING
 			std::cout << "extDB: Loading Log Settings" << std::endl;
@@ -277,7 +329,47 @@ void Ext::stop()
 
 	io_service.stop();
 	threads.join_all();
-	unordered_map_protocol.clear();
+
+	// Cursors put their DB Sessions back before Databases are closed
+	//   Jobs left in Work Queue still hold Cursor Entries, so Cursors are closed here not when Entries are freed
+	cursor_timer.reset();
+	{
+		boost::lock_guard<boost::mutex> lock(mutex_cursors);
+		for (std::unordered_map< int, boost::shared_ptr<CursorEntry> >::iterator itr = cursors.begin(); itr != cursors.end(); ++itr)
+		{
+			itr->second->cursor.reset();
+		}
+		cursors.clear();
+	}
+	circuit_breaker_threads.interrupt_all();
+	circuit_breaker_threads.join_all();
+	journal_threads.interrupt_all();
+	journal_threads.join_all();
+	replica_monitor_threads.interrupt_all();
+	replica_monitor_threads.join_all();
+	for (std::unordered_map< std::string, boost::shared_ptr<DBConnectionInfo> >::iterator itr = databases.begin(); itr != databases.end(); ++itr)
+	{
+		for (std::size_t shard = 0; shard < itr->second->getShardCount(); ++shard)
+		{
+			DBConnectionInfo *shard_database = itr->second->getShardByIndex(shard);
+			shard_database->thread_session.reset();
+			if (shard_database->replica)
+			{
+				shard_database->replica->thread_session.reset();
+			}
+		}
+	}
+
+	{
+		boost::lock_guard<boost::mutex> lock(mutex_protocol_registry);
+		boost::shared_ptr<const ProtocolRegistry> empty_registry(new ProtocolRegistry());
+		protocol_registry.store(empty_registry.get());
+		protocol_registry_snapshots.clear();
+		protocol_registry_snapshots.push_back(empty_registry);
+	}
+
+	default_database = nullptr;
+	databases.clear();
 
 	boost::log::core::get()->remove_all_sinks();
 }
@@ -288,12 +380,12 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 	try
 	{
 		// Check if already connectted to Database.
-		if (!db_conn_info.db_type.empty())
+		if (databases.find(conf_option) != databases.end())
 		{
 			#ifdef TESTING
-				std::cout << "extDB: Already Connected to Database: " << db_conn_info.db_type << "." << std::endl;
+				std::cout << "extDB: Already Connected to Database: " << conf_option << "." << std::endl;
 			#endif
-			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Already Connected to a Database: " << db_conn_info.db_type << ".";
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Already Connected to Database: " << conf_option << ".";
 			std::strcpy(output, "[0,\"Already Connected to Database\"]");
 		}
 		else
@@ -301,28 +393,74 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 			if (pConf->hasOption(conf_option + ".Type"))
 			{
 				// Database
-				db_conn_info.db_type = pConf->getString(conf_option + ".Type");
+				boost::shared_ptr<DBConnectionInfo> database(new DBConnectionInfo());
+				database->name = conf_option;
+				database->db_type = pConf->getString(conf_option + ".Type");
 				std::string db_name = pConf->getString(conf_option + ".Name");
 
-				db_conn_info.min_sessions = pConf->getInt(conf_option + ".minSessions", 1);
-				if (db_conn_info.min_sessions <= 0)
+				database->min_sessions = pConf->getInt(conf_option + ".minSessions", 1);
+				if (database->min_sessions <= 0)
+				{
+					database->min_sessions = 1;
+				}
+				database->max_sessions = pConf->getInt(conf_option + ".maxSessions", 0);
+				if (database->max_sessions <= 0)
+				{
+					// Worker Threads + Arma Server Thread (SYNC Calls) + Open Cursors
+					database->max_sessions = max_threads + 1 + ((int) max_cursors);
+				}
+				if (database->max_sessions < database->min_sessions)
+				{
+					database->max_sessions = database->min_sessions;
+				}
+
+				database->checkout_timeout = pConf->getInt(conf_option + ".Checkout Timeout", 5000);
+				if (database->checkout_timeout < 0)
 				{
-					db_conn_info.min_sessions = 1;
+					database->checkout_timeout = 0;
 				}
-				db_conn_info.min_sessions = pConf->getInt(conf_option + ".maxSessions", 1);
-				if (db_conn_info.max_sessions <= 0)
+
+				database->sync_checkout_timeout = pConf->getInt(conf_option + ".Sync Checkout Timeout", 0);
+				if (database->sync_checkout_timeout < 0)
+				{
+					database->sync_checkout_timeout = 0;
+				}
+
+				database->validation_interval = pConf->getInt(conf_option + ".Validation Interval", 30);
+				if (database->validation_interval < 0)
+				{
+					database->validation_interval = 0;
+				}
+				database->validation_interval = database->validation_interval * 1000;
+
+				database->statement_cache_size = pConf->getInt(conf_option + ".Statement Cache Size", 256);
+				database->statement_cache_memory = pConf->getInt(conf_option + ".Statement Cache Memory", 4096);
+				database->normalize_raw_sql = pConf->getBool(conf_option + ".Normalize Raw SQL", false);
+
+				database->thread_sessions = pConf->getBool(conf_option + ".Thread Sessions", false);
+				if (database->thread_sessions)
 				{
-					db_conn_info.max_sessions = max_threads;
+					// Every Worker Thread + Arma Server Thread (+ Journal Thread) holds a DB Session, Open Cursors hold one each on top
+					int thread_count = max_threads + 1 + ((int) max_cursors);
+					if (pConf->getBool(conf_option + ".Journal", false))
+					{
+						++thread_count;
+					}
+					if (database->max_sessions < thread_count)
+					{
+						database->max_sessions = thread_count;
+					}
+					BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Thread Sessions Enabled";
 				}
 
-				db_conn_info.idle_time = pConf->getInt(conf_option + ".idleTime");
+				database->idle_time = pConf->getInt(conf_option + ".idleTime");
 
 				#ifdef TESTING
-					std::cout << "extDB: Database Type: " << db_conn_info.db_type << std::endl;
+					std::cout << "extDB: Database Type: " << database->db_type << std::endl;
 				#endif
-				BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Type: " << db_conn_info.db_type;
+				BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Type: " << database->db_type;
 
-				if (boost::iequals(db_conn_info.db_type, std::string("MySQL")) == 1)
+				if (boost::iequals(database->db_type, std::string("MySQL")) == 1)
 				{
 					std::string username = pConf->getString(conf_option + ".Username");
 					std::string password = pConf->getString(conf_option + ".Password");
@@ -330,28 +468,44 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 					std::string ip = pConf->getString(conf_option + ".IP");
 					std::string port = pConf->getString(conf_option + ".Port");
 
-					db_conn_info.connection_str = "host=" + ip + ";port=" + port + ";user=" + username + ";password=" + password + ";db=" + db_name + ";auto-reconnect=true";
+					database->connection_str = "host=" + ip + ";port=" + port + ";user=" + username + ";password=" + password + ";db=" + db_name + ";auto-reconnect=true";
 
-					db_conn_info.db_type = "MySQL";
+					database->db_type = "MySQL";
 					Poco::Data::MySQL::Connector::registerConnector();
 					std::string compress = pConf->getString(conf_option + ".Compress", "false");
 					if (boost::iequals(compress, "true") == 1)
 					{
-						db_conn_info.connection_str = db_conn_info.connection_str + ";compress=true";
+						database->connection_str = database->connection_str + ";compress=true";
 					}
 
-					db_pool.reset(new DBPool(db_conn_info.db_type, 
-																db_conn_info.connection_str, 
-																db_conn_info.min_sessions, 
-																db_conn_info.max_sessions, 
-																db_conn_info.idle_time));
-					if (db_pool->get().isConnected())
+					database->pool.reset(new DBPool(database->db_type, 
+																database->connection_str, 
+																database->min_sessions, 
+																database->max_sessions, 
+																database->idle_time));
+					database->pool->extDB_setCheckoutTimeout(database->checkout_timeout);
+					database->pool->extDB_startValidation(database->validation_interval);
+					database->pool->extDB_setStatementCacheSize(database->statement_cache_size);
+					database->pool->extDB_setStatementCacheMemory(database->statement_cache_memory);
+					if (database->pool->get().isConnected())
 					{
 						#ifdef TESTING
 							std::cout << "extDB: Database Session Pool Started" << std::endl;
 						#endif
 						BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Session Pool Started";
 						std::strcpy(output, "[1]");
+						if (pConf->hasOption(conf_option + ".Replica IP"))
+						{
+							connectReplica(database.get(), conf_option);
+						}
+						connectMySQLNative(database.get(), conf_option);
+						databases[conf_option] = database;
+						startCircuitBreaker(database.get(), conf_option);
+						startJournal(database.get(), conf_option);
+						if (default_database == nullptr)
+						{
+							default_database = database.get();
+						}
 					}
 					else
 					{
@@ -360,36 +514,124 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 						#endif
 						BOOST_LOG_SEV(logger, boost::log::trivial::fatal) << "extDB: Database Session Pool Failed";
 						std::strcpy(output, "[0,\"Database Session Pool Failed\"]");
-						db_conn_info = DBConnectionInfo();
 						if (extDB_error_db_kill_server)
 						{
 							std::exit(EXIT_FAILURE);
 						}
 					}
 				}
-				else if (boost::iequals(db_conn_info.db_type, "SQLite") == 1)
+				else if (boost::iequals(database->db_type, "SQLite") == 1)
 				{
-					db_conn_info.db_type = "SQLite";
+					database->db_type = "SQLite";
 					Poco::Data::SQLite::Connector::registerConnector();
 
+					// Shards -- First Shard Name is used instead of Name
+					std::vector<std::string> shard_names;
+					if (pConf->hasOption(conf_option + ".Shard Names"))
+					{
+						Poco::StringTokenizer tokens(pConf->getString(conf_option + ".Shard Names"), ",", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+						shard_names.assign(tokens.begin(), tokens.end());
+						if (!shard_names.empty())
+						{
+							db_name = shard_names[0];
+						}
+					}
+
 					boost::filesystem::path sqlite_path(getExtensionPath());
 					sqlite_path /= "extDB";
 					sqlite_path /= "sqlite";
-					sqlite_path /= "db_name";
-					db_conn_info.connection_str = sqlite_path.make_preferred().string();
-
-					db_pool.reset(new DBPool(db_conn_info.db_type, 
-																db_conn_info.connection_str, 
-																db_conn_info.min_sessions, 
-																db_conn_info.max_sessions, 
-																db_conn_info.idle_time));
-					if (db_pool->get().isConnected())
+					sqlite_path /= db_name;
+					database->connection_str = sqlite_path.make_preferred().string();
+
+					// SQLite Tuning -- PRAGMAs run on every new DB Session
+					std::vector<std::string> session_statements;
+					bool wal = pConf->getBool(conf_option + ".WAL", false);
+					if (wal)
+					{
+						session_statements.push_back("PRAGMA journal_mode=WAL");
+					}
+					if (pConf->hasOption(conf_option + ".Synchronous"))
+					{
+						std::string synchronous = boost::to_upper_copy(pConf->getString(conf_option + ".Synchronous"));
+						if ((synchronous == "OFF") || (synchronous == "NORMAL") || (synchronous == "FULL") || (synchronous == "EXTRA"))
+						{
+							session_statements.push_back("PRAGMA synchronous=" + synchronous);
+						}
+						else
+						{
+							BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: SQLite: Unknown Synchronous Value: " << synchronous;
+						}
+					}
+					if (pConf->hasOption(conf_option + ".Page Cache Size"))
+					{
+						session_statements.push_back("PRAGMA cache_size=" + Poco::NumberFormatter::format(pConf->getInt(conf_option + ".Page Cache Size")));
+					}
+					if (pConf->hasOption(conf_option + ".mmap Size"))
+					{
+						// Megabytes
+						Poco::Int64 mmap_size = pConf->getInt(conf_option + ".mmap Size");
+						session_statements.push_back("PRAGMA mmap_size=" + Poco::NumberFormatter::format(mmap_size * 1024 * 1024));
+					}
+
+					// Readers -- One Writer DB Session, SELECTs run on separate Read Only DB Sessions
+					int readers = pConf->getInt(conf_option + ".Readers", 0);
+					bool reader_thread_sessions = database->thread_sessions;
+					if (readers > 0)
+					{
+						if (!wal)
+						{
+							BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: SQLite: Readers without WAL, Readers are blocked while Writer commits";
+						}
+						database->min_sessions = 1;
+						database->max_sessions = 1;
+						if (database->thread_sessions)
+						{
+							database->thread_sessions = false;
+							BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: SQLite: Thread Sessions only used by Readers";
+						}
+					}
+
+					boost::shared_ptr<DBPool> pool(new DBPool(database->db_type, 
+																database->connection_str, 
+																database->min_sessions, 
+																database->max_sessions, 
+																database->idle_time));
+					pool->session_statements = session_statements;
+					database->pool = pool;
+					database->pool->extDB_setCheckoutTimeout(database->checkout_timeout);
+					database->pool->extDB_startValidation(database->validation_interval);
+					database->pool->extDB_setStatementCacheSize(database->statement_cache_size);
+					database->pool->extDB_setStatementCacheMemory(database->statement_cache_memory);
+					if (database->pool->get().isConnected())
 					{
 						#ifdef TESTING
 							std::cout << "extDB: Database Session Pool Started" << std::endl;
 						#endif
 						BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Session Pool Started";
 						std::strcpy(output, "[1]");
+						if (readers > 0)
+						{
+							connectSQLiteReaders(database.get(), readers, reader_thread_sessions, session_statements);
+						}
+						for (std::vector<std::string>::size_type i = 1; i < shard_names.size(); ++i)
+						{
+							database->shards.push_back(connectSQLiteShard(database.get(), shard_names[i], readers, reader_thread_sessions, session_statements));
+						}
+						if (!shard_names.empty())
+						{
+							#ifdef TESTING
+								std::cout << "extDB: SQLite: " << database->getShardCount() << " Shards" << std::endl;
+							#endif
+							BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: SQLite: " << database->getShardCount() << " Shards";
+						}
+						connectSQLiteNative(database.get(), conf_option, session_statements);
+						databases[conf_option] = database;
+						startCircuitBreaker(database.get(), conf_option);
+						startJournal(database.get(), conf_option);
+						if (default_database == nullptr)
+						{
+							default_database = database.get();
+						}
 					}
 					else
 					{
@@ -398,7 +640,6 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 						#endif
 						BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Database Session Pool Failed";
 						std::strcpy(output, "[0,\"Database Session Pool Failed\"]");
-						db_conn_info = DBConnectionInfo();
 						if (extDB_error_db_kill_server)
 						{
 							std::exit(EXIT_FAILURE);
@@ -412,8 +653,7 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 					#endif 
 					BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: No Database Engine Found for " << db_name << ".";
 					std::strcpy(output, "[0,\"Unknown Database Type\"]");
-					db_conn_info = DBConnectionInfo();
-					if (extDB_error_db_kill_server)
+						if (extDB_error_db_kill_server)
 					{
 						std::exit(EXIT_FAILURE);
 					}
@@ -426,7 +666,6 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 				#endif
 				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: No Config Option Found: " << conf_option << ".";
 				std::strcpy(output, "[0,\"No Config Option Found\"]");
-				db_conn_info = DBConnectionInfo();
 				if (extDB_error_db_kill_server)
 				{
 					std::exit(EXIT_FAILURE);
@@ -441,7 +680,6 @@ void Ext::connectDatabase(char *output, const int &output_size, const std::strin
 		#endif
 		BOOST_LOG_SEV(logger, boost::log::trivial::fatal) << "extDB: Database Setup Failed: " << e.displayText();
 		std::strcpy(output, "[0,\"Database Exception Error\"]");
-		db_conn_info = DBConnectionInfo();
 		if (extDB_error_db_kill_server)
 		{
 			std::exit(EXIT_FAILURE);
@@ -481,304 +719,1776 @@ void Ext::freeUniqueID_mutexlock(const int &unique_id)
 }
 
 
-Poco::Data::Session Ext::getDBSession_mutexlock()
-// Gets available DB Session (mutex lock)
+DBConnectionInfo::ThreadSession *Ext::getThreadSession(DBConnectionInfo *database)
+// Gets DB Session owned by current Thread, checks out a new DB Session if missing or broken
+//	DB Session is only checked once per Validation Interval
 {
-	try
+	DBConnectionInfo::ThreadSession *session_ptr = database->thread_session.get();
+	if (session_ptr != nullptr)
 	{
-		boost::lock_guard<boost::mutex> lock(mutex_db_pool);
-		Poco::Data::Session free_session =  db_pool->get();
-		return free_session;
+		if (session_ptr->itr->invalidated)
+		{
+			session_ptr = nullptr;
+		}
+		else if (session_ptr->validated.isElapsed(((Poco::Timestamp::TimeDiff) database->validation_interval) * 1000))
+		{
+			if (session_ptr->session.isConnected())
+			{
+				session_ptr->validated.update();
+			}
+			else
+			{
+				invalidateDBSessionCustom_mutexlock(database, session_ptr->itr);
+				session_ptr = nullptr;
+			}
+		}
 	}
-	catch (Poco::Data::SessionPoolExhaustedException&)
-	//	Exceptiontal Handling in event of scenario if all asio worker threads are busy using all db connections
-	//		And there is SYNC call using db & db_pool = exhausted
+	if (session_ptr == nullptr)
 	{
-		Poco::Data::Session new_session(db_conn_info.db_type, db_conn_info.connection_str);
-		return new_session;
+		// Old DB Session is put back to pool + closed, since its invalidated
+		database->thread_session.reset();
+		session_ptr = new DBConnectionInfo::ThreadSession(database->pool.get());
+		database->thread_session.reset(session_ptr);
+		if (database->circuit_failures.load() != 0)
+		{
+			database->circuit_failures = 0;
+		}
 	}
+	return session_ptr;
 }
 
- 
-Poco::Data::Session Ext::getDBSessionCustom_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr)
-// Gets available DB Session (mutex lock)
+
+void Ext::connectReplica(DBConnectionInfo *database, const std::string &conf_option)
+// Starts Session Pool for Read Replica of a MySQL Database, uses same Settings as Primary unless set
+//	Replica isn't used till first Health Check passes
 {
-	boost::lock_guard<boost::mutex> lock(mutex_db_pool);
-	Poco::Data::Session free_session =  db_pool->extDB_get(itr);
-	return free_session;
+	boost::shared_ptr<DBConnectionInfo> replica(new DBConnectionInfo());
+	replica->name = database->name + ":Replica";
+	replica->db_type = database->db_type;
+	replica->primary = database;
+	replica->min_sessions = database->min_sessions;
+	replica->max_sessions = database->max_sessions;
+	replica->idle_time = database->idle_time;
+	replica->checkout_timeout = database->checkout_timeout;
+	replica->sync_checkout_timeout = database->sync_checkout_timeout;
+	replica->thread_sessions = database->thread_sessions;
+	replica->validation_interval = database->validation_interval;
+	replica->statement_cache_size = database->statement_cache_size;
+	replica->statement_cache_memory = database->statement_cache_memory;
+	replica->normalize_raw_sql = database->normalize_raw_sql;
+
+	std::string username = pConf->getString(conf_option + ".Replica Username", pConf->getString(conf_option + ".Username"));
+	std::string password = pConf->getString(conf_option + ".Replica Password", pConf->getString(conf_option + ".Password"));
+	std::string db_name = pConf->getString(conf_option + ".Replica Name", pConf->getString(conf_option + ".Name"));
+
+	std::string ip = pConf->getString(conf_option + ".Replica IP");
+	std::string port = pConf->getString(conf_option + ".Replica Port", pConf->getString(conf_option + ".Port"));
+
+	replica->connection_str = "host=" + ip + ";port=" + port + ";user=" + username + ";password=" + password + ";db=" + db_name + ";auto-reconnect=true";
+	std::string compress = pConf->getString(conf_option + ".Compress", "false");
+	if (boost::iequals(compress, "true") == 1)
+	{
+		replica->connection_str = replica->connection_str + ";compress=true";
+	}
+
+	replica->pool.reset(new DBPool(replica->db_type, 
+											replica->connection_str, 
+											replica->min_sessions, 
+											replica->max_sessions, 
+											replica->idle_time));
+	replica->pool->extDB_setCheckoutTimeout(replica->checkout_timeout);
+	replica->pool->extDB_startValidation(replica->validation_interval);
+	replica->pool->extDB_setStatementCacheSize(replica->statement_cache_size);
+	replica->pool->extDB_setStatementCacheMemory(replica->statement_cache_memory);
+
+	database->replica_max_lag = pConf->getInt(conf_option + ".Replica Max Lag", 10);
+	if (database->replica_max_lag < 0)
+	{
+		database->replica_max_lag = 0;
+	}
+	database->replica_check_interval = pConf->getInt(conf_option + ".Replica Check Interval", 5);
+	if (database->replica_check_interval <= 0)
+	{
+		database->replica_check_interval = 1;
+	}
+	database->replica = replica;
+	database->replica_available = checkReplica(database);
+
+	#ifdef TESTING
+		std::cout << "extDB: Database Replica Session Pool Started" << std::endl;
+	#endif
+	BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Database Replica Session Pool Started, Available: " << database->replica_available.load();
+
+	replica_monitor_threads.create_thread(boost::bind(&Ext::replicaMonitor, this, database));
 }
 
 
-void Ext::putbackDBSession_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr)
-// Gets available DB Session (mutex lock)
+void Ext::connectSQLiteReaders(DBConnectionInfo *database, int readers, bool thread_sessions, std::vector<std::string> session_statements)
+// Read Only DB Sessions for SQLite, used the same as a Read Replica (always available)
+//	WAL = Readers never wait on Writer
 {
-	boost::lock_guard<boost::mutex> lock(mutex_db_pool);
-	db_pool->putBack(itr);
+	boost::shared_ptr<DBConnectionInfo> replica(new DBConnectionInfo());
+	replica->name = database->name + ":Readers";
+	replica->db_type = database->db_type;
+	replica->connection_str = database->connection_str;
+	replica->primary = database;
+	replica->min_sessions = 1;
+	replica->max_sessions = readers;
+	replica->idle_time = database->idle_time;
+	replica->checkout_timeout = database->checkout_timeout;
+	replica->sync_checkout_timeout = database->sync_checkout_timeout;
+	replica->thread_sessions = thread_sessions;
+	if (replica->thread_sessions && (replica->max_sessions < (max_threads + 1)))
+	{
+		replica->max_sessions = max_threads + 1;
+	}
+	replica->validation_interval = database->validation_interval;
+	replica->statement_cache_size = database->statement_cache_size;
+	replica->statement_cache_memory = database->statement_cache_memory;
+	replica->normalize_raw_sql = database->normalize_raw_sql;
+
+	session_statements.push_back("PRAGMA query_only=1");
+	boost::shared_ptr<DBPool> pool(new DBPool(replica->db_type, 
+												replica->connection_str, 
+												replica->min_sessions, 
+												replica->max_sessions, 
+												replica->idle_time));
+	pool->session_statements = session_statements;
+	replica->pool = pool;
+	replica->pool->extDB_setCheckoutTimeout(replica->checkout_timeout);
+	replica->pool->extDB_startValidation(replica->validation_interval);
+	replica->pool->extDB_setStatementCacheSize(replica->statement_cache_size);
+	replica->pool->extDB_setStatementCacheMemory(replica->statement_cache_memory);
+
+	database->replica = replica;
+	database->replica_available = true;
+
+	#ifdef TESTING
+		std::cout << "extDB: SQLite: " << replica->max_sessions << " Readers + 1 Writer" << std::endl;
+	#endif
+	BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: SQLite: " << replica->max_sessions << " Readers + 1 Writer";
 }
 
 
-std::string Ext::getDBType()
+boost::shared_ptr<DBConnectionInfo> Ext::connectSQLiteShard(DBConnectionInfo *database, const std::string &shard_name, int readers, bool reader_thread_sessions, const std::vector<std::string> &session_statements)
+// SQLite Shard, uses same Settings as Shard 0
+//	Session Pool opens lazily, so a bad Shard File fails on first Call
 {
-	return db_conn_info.db_type;
+	boost::shared_ptr<DBConnectionInfo> shard(new DBConnectionInfo());
+	shard->name = database->name + ":" + shard_name;
+	shard->db_type = database->db_type;
+	shard->min_sessions = database->min_sessions;
+	shard->max_sessions = database->max_sessions;
+	shard->idle_time = database->idle_time;
+	shard->checkout_timeout = database->checkout_timeout;
+	shard->sync_checkout_timeout = database->sync_checkout_timeout;
+	shard->thread_sessions = database->thread_sessions;
+	shard->validation_interval = database->validation_interval;
+	shard->statement_cache_size = database->statement_cache_size;
+	shard->statement_cache_memory = database->statement_cache_memory;
+	shard->normalize_raw_sql = database->normalize_raw_sql;
+
+	boost::filesystem::path sqlite_path(getExtensionPath());
+	sqlite_path /= "extDB";
+	sqlite_path /= "sqlite";
+	sqlite_path /= shard_name;
+	shard->connection_str = sqlite_path.make_preferred().string();
+
+	boost::shared_ptr<DBPool> pool(new DBPool(shard->db_type, 
+												shard->connection_str, 
+												shard->min_sessions, 
+												shard->max_sessions, 
+												shard->idle_time));
+	pool->session_statements = session_statements;
+	shard->pool = pool;
+	shard->pool->extDB_setCheckoutTimeout(shard->checkout_timeout);
+	shard->pool->extDB_startValidation(shard->validation_interval);
+	shard->pool->extDB_setStatementCacheSize(shard->statement_cache_size);
+	shard->pool->extDB_setStatementCacheMemory(shard->statement_cache_memory);
+
+	if (readers > 0)
+	{
+		connectSQLiteReaders(shard.get(), readers, reader_thread_sessions, session_statements);
+	}
+	return shard;
 }
 
 
-void Ext::getSinglePartResult_mutexlock(const int &unique_id, char *output, const int &output_size)
-// Gets Result String from unordered map array -- Result Formt == Single-Message
-//   If <=, then sends output to arma, and removes entry from unordered map array
-//   If >, sends [5] to indicate MultiPartResult
+void Ext::connectSQLiteNative(DBConnectionInfo *database, const std::string &conf_option, const std::vector<std::string> &session_statements)
+// Native sqlite3 Pool for every Shard + its Readers, DB_RAW + DB_CUSTOM_V5 Calls skip Poco::Data Statement + RecordSet
+//	Uses same Session Limits + PRAGMAs as the Poco DB Session Pools
+//	Readers = only Readers get a Native Pool, Writes stay on the single Poco Writer DB Session
 {
-	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
-	std::unordered_map<int, std::string>::const_iterator it = unordered_map_results.find(unique_id);
-	if (it == unordered_map_results.end()) // NO UNIQUE ID or WAIT
+	if (!pConf->getBool(conf_option + ".Native", false))
 	{
-		if (unordered_map_wait.count(unique_id) == 0)
-		{
-			std::strcpy(output, (""));
-		}
-		else
+		return;
+	}
+
+	#ifdef NATIVE_SQLITE
+		std::vector<std::string> reader_statements(session_statements);
+		reader_statements.push_back("PRAGMA query_only=1");
+		for (std::size_t i = 0; i < database->getShardCount(); ++i)
 		{
-			std::strcpy(output, ("[3]"));
+			DBConnectionInfo *shard = database->getShardByIndex(i);
+			if (shard->replica)
+			{
+				shard->replica->native.reset(new SQLiteNativePool(shard->replica->connection_str, shard->replica->max_sessions, shard->replica->checkout_timeout, shard->replica->sync_checkout_timeout, shard->replica->statement_cache_size, reader_statements));
+			}
+			else
+			{
+				shard->native.reset(new SQLiteNativePool(shard->connection_str, shard->max_sessions, shard->checkout_timeout, shard->sync_checkout_timeout, shard->statement_cache_size, session_statements));
+			}
 		}
-	}
-	else // SEND MSG (Part)
+		#ifdef TESTING
+			std::cout << "extDB: SQLite: Native Backend" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: SQLite: Native Backend";
+	#else
+		#ifdef TESTING
+			std::cout << "extDB: SQLite: Native Backend not compiled in (NATIVE_SQLITE), using Poco" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: SQLite: Native Backend not compiled in (NATIVE_SQLITE), using Poco";
+	#endif
+}
+
+
+void Ext::connectMySQLNative(DBConnectionInfo *database, const std::string &conf_option)
+// Native libmysqlclient Pool for Database + its Read Replica, DB_RAW + DB_CUSTOM_V5 Calls skip Poco::Data Statement + RecordSet
+//	Uses same Session Limits as the Poco DB Session Pools
+{
+	if (!pConf->getBool(conf_option + ".Native", false))
 	{
-		if (it->second.length() > output_size)
+		return;
+	}
+
+	#ifdef NATIVE_MYSQL
+		database->native.reset(new MySQLNativePool(database->connection_str, database->max_sessions, database->checkout_timeout, database->sync_checkout_timeout,
+			database->validation_interval, database->statement_cache_size, boost::bind(&Ext::recordNativeStatus, this, database, _1)));
+		if (database->replica)
 		{
-			std::strcpy(output, ("[5]"));
+			database->replica->native.reset(new MySQLNativePool(database->replica->connection_str, database->replica->max_sessions, database->replica->checkout_timeout, database->replica->sync_checkout_timeout,
+				database->replica->validation_interval, database->replica->statement_cache_size, boost::bind(&Ext::recordNativeStatus, this, database->replica.get(), _1)));
 		}
-		else
+		#ifdef TESTING
+			std::cout << "extDB: MySQL: Native Backend" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: MySQL: Native Backend";
+	#else
+		#ifdef TESTING
+			std::cout << "extDB: MySQL: Native Backend not compiled in (NATIVE_MYSQL), using Poco" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: MySQL: Native Backend not compiled in (NATIVE_MYSQL), using Poco";
+	#endif
+}
+
+
+bool Ext::checkReplica(DBConnectionInfo *database)
+// Replica is available if it is connected + Seconds_Behind_Master is within Replica Max Lag
+//	Replica without Slave Status (i.e Replication not setup) is treated as no Lag
+{
+	try
+	{
+		Poco::Data::Session session = database->replica->pool->get();
+		Poco::Data::Statement sql(session);
+		sql << "SHOW SLAVE STATUS", Poco::Data::now;
+		Poco::Data::RecordSet rs(sql);
+		if ((database->replica_max_lag > 0) && rs.moveFirst())
 		{
-			std::string msg = it->second.substr(0, output_size);
-			std::strcpy(output, msg.c_str());
-			unordered_map_results.erase(unique_id);
-			freeUniqueID_mutexlock(unique_id);
+			Poco::DynamicAny lag = rs["Seconds_Behind_Master"];
+			if (lag.isEmpty())
+			{
+				// NULL = Replication Stopped
+				return false;
+			}
+			return (lag.convert<int>() <= database->replica_max_lag);
 		}
+		return true;
+	}
+	catch (Poco::Exception& e)
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Database Replica Check: Error: " << e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Database Replica Check: Error: " << e.displayText();
+		return false;
 	}
 }
 
 
-void Ext::getMultiPartResult_mutexlock(const int &unique_id, char *output, const int &output_size)
-// Gets Result String from unordered map array  -- Result Format = Multi-Message 
-//   If length of String = 0, sends arma "", and removes entry from unordered map array
-//   If <=, then sends output to arma
-//   If >, then sends 1 part to arma + stores rest.
+void Ext::replicaMonitor(DBConnectionInfo *database)
+// Replica Health Check Thread, checks Replica every Replica Check Interval
+//	Interrupted by stop()
 {
-	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
-	std::unordered_map<int, std::string>::const_iterator it = unordered_map_results.find(unique_id);
-	if (it == unordered_map_results.end()) // NO UNIQUE ID or WAIT
+	try
 	{
-		if (unordered_map_wait.count(unique_id) == 0)
-		{
-			std::strcpy(output, (""));
-		}
-		else
+		while (true)
 		{
-			std::strcpy(output, ("[3]"));
+			boost::this_thread::sleep_for(boost::chrono::seconds(database->replica_check_interval));
+
+			bool available = checkReplica(database);
+			if (database->replica_available.exchange(available) != available)
+			{
+				#ifdef TESTING
+					std::cout << "extDB: Database Replica " << database->replica->name << (available ? " Available" : " Unavailable, using Primary") << std::endl;
+				#endif
+				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Database Replica " << database->replica->name << (available ? " Available" : " Unavailable, using Primary");
+			}
 		}
 	}
-	else if (it->second.empty()) // END of MSG
+	catch (boost::thread_interrupted&)
 	{
-		unordered_map_results.erase(unique_id);
-		freeUniqueID_mutexlock(unique_id);
-		std::strcpy(output, (""));
 	}
-	else // SEND MSG (Part)
+}
+
+
+void Ext::startCircuitBreaker(DBConnectionInfo *database, const std::string &conf_option)
+// Circuit Breaker Database Options + starts Circuit Breaker Thread
+{
+	database->circuit_threshold = pConf->getInt(conf_option + ".Circuit Breaker Threshold", 3);
+	if (database->circuit_threshold <= 0)
 	{
-		std::string msg = it->second.substr(0, output_size);
-		std::strcpy(output, msg.c_str());
-		if (it->second.length() > output_size)
+		database->circuit_threshold = 0;
+		return;
+	}
+	database->circuit_backoff = pConf->getInt(conf_option + ".Circuit Breaker Backoff", 1000);
+	if (database->circuit_backoff <= 0)
+	{
+		database->circuit_backoff = 1000;
+	}
+	database->circuit_max_backoff = pConf->getInt(conf_option + ".Circuit Breaker Max Backoff", 60000);
+	if (database->circuit_max_backoff < database->circuit_backoff)
+	{
+		database->circuit_max_backoff = database->circuit_backoff;
+	}
+
+	circuit_breaker_threads.create_thread(boost::bind(&Ext::circuitBreaker, this, database));
+}
+
+
+void Ext::recordDBFailure(DBConnectionInfo *database)
+// Connection Failure, opens Circuit after Circuit Breaker Threshold Failures in a row
+{
+	if ((database->circuit_threshold > 0) && (++database->circuit_failures >= database->circuit_threshold))
+	{
+		if (!database->circuit_open.exchange(true))
 		{
-			unordered_map_results[unique_id] = it->second.substr(output_size);
+			#ifdef TESTING
+				std::cout << "extDB: Circuit Breaker: Database " << database->name << " Unavailable" << std::endl;
+			#endif
+			BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Circuit Breaker: Database " << database->name << " Unavailable";
+			boost::lock_guard<boost::mutex> lock(database->circuit_mutex);
+			database->circuit_condition.notify_one();
 		}
-		else
+	}
+}
+
+
+void Ext::recordNativeStatus(DBConnectionInfo *database, bool connected)
+// Native Backend Connection Status, same as DB Session Checkout / invalidateDBSession for the Poco Path
+{
+	if (database->primary != nullptr)
+	{
+		if ((!connected) && (database->primary->replica_check_interval > 0))
 		{
-			unordered_map_results[unique_id].clear();
+			database->primary->replica_available = false;
 		}
 	}
+	else if (!connected)
+	{
+		recordDBFailure(database);
+	}
+	else if (database->circuit_failures.load() != 0)
+	{
+		database->circuit_failures = 0;
+	}
 }
 
 
-void Ext::saveResult_mutexlock(const std::string &result, const int &unique_id)
-// Stores Result String  in a unordered map array.
-//   Used when string > arma output char
+bool Ext::circuitOpen(const boost::shared_ptr<AbstractProtocol> &protocol)
 {
-	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
-	unordered_map_results[unique_id] = "[1," + result + "]";
-	unordered_map_wait.erase(unique_id);
+	return ((protocol->database != nullptr) && (protocol->database->circuit_open.load()));
+}
+
+
+bool Ext::probeDatabase(DBConnectionInfo *database)
+// Opens a new DB Session outside of the Session Pool
+{
+	try
+	{
+		Poco::Data::Session session(database->db_type, database->connection_str);
+		return session.isConnected();
+	}
+	catch (Poco::Exception& e)
+	{
+		#ifdef DEBUG_LOGGING
+			BOOST_LOG_SEV(logger, boost::log::trivial::trace) << "extDB: Circuit Breaker: Probe Failed: " << e.displayText();
+		#endif
+		return false;
+	}
 }
 
 
-void Ext::addProtocol(char *output, const int &output_size, const std::string &protocol, const std::string &protocol_name, const std::string &init_data)
+void Ext::circuitBreaker(DBConnectionInfo *database)
+// Circuit Breaker Thread, waits for Circuit to open then probes Database with Exponential Backoff
+//	Interrupted by stop()
 {
+	try
 	{
-		boost::lock_guard<boost::mutex> lock(mutex_unordered_map_protocol);
-		if (boost::iequals(protocol, std::string("MISC")) == 1)
+		while (true)
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new MISC());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
 			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
+				boost::unique_lock<boost::mutex> lock(database->circuit_mutex);
+				database->circuit_condition.wait(lock, [database]{ return database->circuit_open.load(); });
 			}
-			else
+
+			int backoff = database->circuit_backoff;
+			while (true)
 			{
-				std::strcpy(output, "[1]");
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(backoff));
+				if (probeDatabase(database))
+				{
+					break;
+				}
+				backoff = std::min(backoff * 2, database->circuit_max_backoff);
+				#ifdef DEBUG_LOGGING
+					BOOST_LOG_SEV(logger, boost::log::trivial::trace) << "extDB: Circuit Breaker: Database " << database->name << " Next Probe: " << backoff << "ms";
+				#endif
 			}
+
+			database->circuit_failures = 0;
+			database->circuit_open = false;
+			#ifdef TESTING
+				std::cout << "extDB: Circuit Breaker: Database " << database->name << " Available" << std::endl;
+			#endif
+			BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Circuit Breaker: Database " << database->name << " Available";
+		}
+	}
+	catch (boost::thread_interrupted&)
+	{
+	}
+}
+
+
+void Ext::startJournal(DBConnectionInfo *database, const std::string &conf_option)
+// Write Journal Database Options, maps extDB/journal/<Database>.journal + starts Journal Thread
+//	Journal left over from last run is drained once its Protocols are added
+{
+	if (!pConf->getBool(conf_option + ".Journal", false))
+	{
+		return;
+	}
+
+	boost::filesystem::path journal_path(extDB_path);
+	journal_path /= "extDB";
+	journal_path /= "journal";
+	boost::filesystem::create_directories(journal_path);
+	journal_path /= (database->name + ".journal");
+
+	int journal_size = pConf->getInt(conf_option + ".Journal Size", 64);
+	if (journal_size <= 0)
+	{
+		journal_size = 64;
+	}
+	database->journal_batch_size = pConf->getInt(conf_option + ".Journal Batch Size", 500);
+	if (database->journal_batch_size <= 0)
+	{
+		database->journal_batch_size = 500;
+	}
+	database->journal_retries = pConf->getInt(conf_option + ".Journal Retries", 3);
+	if (database->journal_retries <= 0)
+	{
+		database->journal_retries = 3;
+	}
+
+	boost::shared_ptr<WriteJournal> journal(new WriteJournal());
+	if (!journal->open(journal_path.make_preferred().string(), ((std::size_t) journal_size) * 1024 * 1024))
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Journal: Failed to open " << journal_path.make_preferred().string() << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Journal: Failed to open " << journal_path.make_preferred().string();
+		return;
+	}
+	database->journal = journal;
+
+	#ifdef TESTING
+		std::cout << "extDB: Journal: " << journal_path.make_preferred().string() << ", Undrained: " << journal->pending() << " bytes" << std::endl;
+	#endif
+	BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Journal: " << journal_path.make_preferred().string() << ", Undrained: " << journal->pending() << " bytes";
+
+	journal_threads.create_thread(boost::bind(&Ext::drainJournal, this, database));
+}
+
+
+bool Ext::journalCall(DBConnectionInfo *database, const std::string &protocol_key, const std::string &data)
+// Appends One-Way Call to Write Journal
+//	Returns false if Journal is disabled or full
+{
+	if ((database == nullptr) || (!database->journal))
+	{
+		return false;
+	}
+	return database->journal->append(protocol_key, data);
+}
+
+
+const Ext::ProtocolEntry *Ext::findJournalProtocol(std::unordered_map<std::string, const ProtocolEntry *> &protocols, const std::string &protocol_key)
+// Journal Key -> Protocol Entry, Protocols are looked up once per Journal Batch
+{
+	std::unordered_map<std::string, const ProtocolEntry *>::iterator itr = protocols.find(protocol_key);
+	if (itr == protocols.end())
+	{
+		const ProtocolRegistry *registry = protocol_registry.load();
+		std::unordered_map< std::string, int >::const_iterator handle_itr = registry->journal_handles.find(protocol_key);
+		const ProtocolEntry *entry = nullptr;
+		if (handle_itr != registry->journal_handles.end())
+		{
+			entry = &(registry->protocols[handle_itr->second]);
+		}
+		itr = protocols.emplace(protocol_key, entry).first;
+	}
+	return itr->second;
+}
+
+
+void Ext::deadLetterJournal(DBConnectionInfo *database, const WriteJournal::Entry &entry, const std::string &reason)
+{
+	if (!database->journal->deadLetter(entry))
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Journal: Failed to write Dead Letter, Dropped Call: " << entry.protocol_key << ": " << entry.data << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Journal: Failed to write Dead Letter, Dropped Call: " << entry.protocol_key << ": " << entry.data;
+	}
+	#ifdef TESTING
+		std::cout << "extDB: Journal: " << reason << ", Dead Lettered Call: " << entry.protocol_key << ": " << entry.data << std::endl;
+	#endif
+	BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Journal: " << reason << ", Dead Lettered Call: " << entry.protocol_key << ": " << entry.data;
+}
+
+
+void Ext::drainJournal(DBConnectionInfo *database)
+// Journal Thread, runs journaled One-Way Calls in Journal Order on this Thread
+//	Calls of a Batch run in one Transaction on one pinned DB Session, Journal is committed up to the last Call that succeeded
+//	Failed Call = rolled back to a Savepoint before it, Batch stops + Call is retried, dead lettered after Journal Retries attempts
+//	Unknown Protocol = Call is moved to end of Journal for the first 60 seconds (Journal left over from last run, Protocols not added yet), then dead lettered
+//		Moved Calls don't hold up the Calls behind them, they are appended again once the Batch is committed
+//	Lost DB Session / Circuit opened = Batch is rolled back + runs again once Database is back
+//	Interrupted by stop()
+{
+	std::vector<WriteJournal::Entry> entries;
+	entries.reserve(database->journal_batch_size);
+	std::unordered_map<std::string, const ProtocolEntry *> protocols;
+	std::vector<WriteJournal::Entry> requeue;
+	std::string result;
+	result.reserve(2000);
+
+	const Poco::Timestamp started;
+	boost::uint64_t failed_call = 0;  // Journal Offset after last failed Call
+	int failed_attempts = 0;
+	try
+	{
+		while (true)
+		{
+			if (!database->journal->wait(1000))
+			{
+				continue;
+			}
+			if (database->circuit_open.load())
+			{
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(500));
+				continue;
+			}
+
+			entries.clear();
+			database->journal->read(entries, database->journal_batch_size);
+			protocols.clear();
+			requeue.clear();
+
+			try
+			{
+				database->pinned_session.reset(new DBConnectionInfo::PinnedSession(database->pool.get(), database->checkout_timeout));
+			}
+			catch (Poco::Data::MySQL::ConnectionException&)
+			{
+				recordDBFailure(database);
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(1000));
+				continue;
+			}
+			catch (Poco::Exception& e)
+			{
+				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Journal: " << e.displayText();
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(1000));
+				continue;
+			}
+			DBConnectionInfo::PinnedSession *pinned = database->pinned_session.get();
+
+			boost::uint64_t drained = 0;
+			bool aborted = false;
+			bool paused = false;
+			try
+			{
+				pinned->session.begin();
+				for (std::vector<WriteJournal::Entry>::iterator itr = entries.begin(); itr != entries.end(); ++itr)
+				{
+					const ProtocolEntry *entry = findJournalProtocol(protocols, itr->protocol_key);
+					if (entry == nullptr)
+					{
+						if (!started.isElapsed(60000000))
+						{
+							requeue.push_back(*itr);
+							drained = itr->next;
+							continue;
+						}
+						deadLetterJournal(database, *itr, "Unknown Protocol");
+						drained = itr->next;
+						continue;
+					}
+
+					pinned->session << "SAVEPOINT extDB_Journal", Poco::Data::now;
+					result.clear();
+					runProtocol(entry->protocol, itr->data, result, nullptr);
+					if (pinned->itr->invalidated || database->circuit_open.load())
+					{
+						aborted = true;
+						break;
+					}
+					if (boost::algorithm::starts_with(result, "[1"))
+					{
+						drained = itr->next;
+						continue;
+					}
+
+					// Failed Call, Calls before it are kept
+					pinned->session << "ROLLBACK TO SAVEPOINT extDB_Journal", Poco::Data::now;
+					if (failed_call == itr->next)
+					{
+						++failed_attempts;
+					}
+					else
+					{
+						failed_call = itr->next;
+						failed_attempts = 1;
+					}
+					if (failed_attempts >= database->journal_retries)
+					{
+						deadLetterJournal(database, *itr, "Call failed " + Poco::NumberFormatter::format(failed_attempts) + " times: " + result);
+						failed_call = 0;
+						failed_attempts = 0;
+						drained = itr->next;
+						continue;
+					}
+					BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Journal: Call failed, retrying: " << itr->protocol_key << ": " << itr->data << " " << result;
+					paused = true;
+					break;
+				}
+			}
+			catch (Poco::Exception& e)
+			{
+				// i.e Savepoint is gone after Deadlock rolled back the Transaction
+				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Journal: Batch rolled back: " << e.displayText();
+				aborted = true;
+			}
+
+			try
+			{
+				if (aborted)
+				{
+					drained = 0;
+					pinned->session.rollback();
+				}
+				else
+				{
+					pinned->session.commit();
+				}
+			}
+			catch (Poco::Exception& e)
+			{
+				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Journal: Batch rolled back: " << e.displayText();
+				drained = 0;
+				aborted = true;
+			}
+			database->pinned_session.reset();
+
+			if (drained != 0)
+			{
+				// Moved Calls are appended before their old Entries are committed, a crash in between runs them twice like any undrained Call
+				for (std::vector<WriteJournal::Entry>::iterator itr = requeue.begin(); itr != requeue.end(); ++itr)
+				{
+					if (!database->journal->append(itr->protocol_key, itr->data))
+					{
+						deadLetterJournal(database, *itr, "Journal Full, Unknown Protocol");
+					}
+				}
+				database->journal->commit(drained);
+				if ((!requeue.empty()) && (requeue.size() == entries.size()))
+				{
+					// Only Unknown Protocols in Journal, wait for them to be added
+					paused = true;
+				}
+			}
+			if (aborted || paused)
+			{
+				boost::this_thread::sleep_for(boost::chrono::milliseconds(1000));
+			}
+		}
+	}
+	catch (boost::thread_interrupted&)
+	{
+		database->pinned_session.reset();
+	}
+}
+
+
+Poco::Data::Session Ext::getDBSession_mutexlock(DBConnectionInfo *database)
+// Gets available DB Session (mutex lock)
+//	If all DB Sessions are in use, waits up to Checkout Timeout then throws SessionPoolExhaustedException
+//	Thread Sessions = no lock
+{
+	try
+	{
+		if (database->pinned_session.get() != nullptr)
+		{
+			return database->pinned_session->session;
+		}
+		if (database->thread_sessions)
+		{
+			return getThreadSession(database)->session;
+		}
+		Poco::Data::Session session = database->pool->extDB_get(database->getCheckoutTimeout());
+		if (database->circuit_failures.load() != 0)
+		{
+			database->circuit_failures = 0;
+		}
+		return session;
+	}
+	catch (Poco::Data::MySQL::ConnectionException&)
+	{
+		// Failed to open new DB Session
+		recordDBFailure(database);
+		throw;
+	}
+}
+
+ 
+Poco::Data::Session Ext::getDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)
+// Gets available DB Session (mutex lock)
+//	Thread Sessions = no lock, Statement Cache stays with the Thread
+{
+	try
+	{
+		if (database->pinned_session.get() != nullptr)
+		{
+			itr = database->pinned_session->itr;
+			return database->pinned_session->session;
+		}
+		if (database->thread_sessions)
+		{
+			DBConnectionInfo::ThreadSession *session_ptr = getThreadSession(database);
+			itr = session_ptr->itr;
+			return session_ptr->session;
+		}
+		Poco::Data::Session session = database->pool->extDB_get(itr, database->getCheckoutTimeout());
+		if (database->circuit_failures.load() != 0)
+		{
+			database->circuit_failures = 0;
+		}
+		return session;
+	}
+	catch (Poco::Data::MySQL::ConnectionException&)
+	{
+		// Failed to open new DB Session
+		recordDBFailure(database);
+		throw;
+	}
+}
+
+
+void Ext::putbackDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)
+// Gets available DB Session (mutex lock)
+//	Thread Sessions = DB Session is kept by the Thread, Pinned Session = DB Session is kept till end of Journal Batch
+{
+	if ((!database->thread_sessions) && (database->pinned_session.get() == nullptr))
+	{
+		database->pool->putBack(itr);
+	}
+}
+
+
+void Ext::invalidateDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::Session &session)
+// Marks DB Session as broken (i.e Connection Exception), its closed instead of put back
+//	Replica = Read Only Calls fallback to Primary till next Replica Health Check passes
+{
+	if (database->primary != nullptr)
+	{
+		if (database->primary->replica_check_interval > 0)
+		{
+			database->primary->replica_available = false;
+		}
+	}
+	else
+	{
+		recordDBFailure(database);
+	}
+	if (database->pinned_session.get() != nullptr)
+	{
+		database->pool->extDB_invalidate(database->pinned_session->itr);
+	}
+	else if (database->thread_sessions)
+	{
+		DBConnectionInfo::ThreadSession *session_ptr = database->thread_session.get();
+		if (session_ptr != nullptr)
+		{
+			database->pool->extDB_invalidate(session_ptr->itr);
+		}
+	}
+	else
+	{
+		database->pool->extDB_invalidate(session);
+	}
+}
+
+
+void Ext::invalidateDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)
+// Marks DB Session as broken (i.e Connection Exception), its closed instead of put back
+//	Replica = Read Only Calls fallback to Primary till next Replica Health Check passes
+{
+	if (database->primary != nullptr)
+	{
+		if (database->primary->replica_check_interval > 0)
+		{
+			database->primary->replica_available = false;
+		}
+	}
+	else
+	{
+		recordDBFailure(database);
+	}
+	database->pool->extDB_invalidate(itr);
+}
+
+
+bool Ext::warmupDBSessions(DBConnectionInfo *database, const boost::function<bool (Poco::Data::Session &, Poco::Data::StatementLRUCache &)> &prepare, int timeout)
+// Opens DB Sessions in parallel on Worker Threads + runs prepare on each DB Session, blocks till finished or timeout (milliseconds)
+//	Thread Sessions = DB Session of Worker Threads that run a Job (busy Worker Threads aren't waited for), else minSessions (limited to number of Worker Threads)
+//	Returns false if a DB Session failed to open, prepare failed or Warmup timed out
+{
+	unsigned int sessions = max_threads;
+	if ((!database->thread_sessions) && (database->min_sessions < max_threads))
+	{
+		sessions = database->min_sessions;
+	}
+
+	boost::shared_ptr<WarmupJob> job(new WarmupJob());
+	for (unsigned int i = 0; i < sessions; ++i)
+	{
+		io_service.post(boost::bind(&Ext::warmupDBSession, this, database, job, prepare));
+	}
+
+	boost::unique_lock<boost::mutex> lock(job->mutex);
+	if (!job->condition.wait_for(lock, boost::chrono::milliseconds(timeout), [&job, sessions]{ return job->completed == sessions; }))
+	{
+		job->timed_out = true;
+		job->status = false;
+		#ifdef TESTING
+			std::cout << "extDB: Warmup: Timeout: " << job->completed << "/" << sessions << " DB Sessions warmed" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::fatal) << "extDB: Warmup: Timeout: " << job->completed << "/" << sessions << " DB Sessions warmed";
+	}
+	for (std::vector< Poco::Data::SessionPool::SessionList::iterator >::iterator itr = job->sessions.begin(); itr != job->sessions.end(); ++itr)
+	{
+		database->pool->putBack(*itr);
+	}
+	job->sessions.clear();
+	return job->status;
+}
+
+
+void Ext::warmupDBSession(DBConnectionInfo *database, boost::shared_ptr<WarmupJob> job, boost::function<bool (Poco::Data::Session &, Poco::Data::StatementLRUCache &)> prepare)
+{
+	bool status = true;
+	bool checked_out = false;
+	Poco::Data::SessionPool::SessionList::iterator itr;
+	try
+	{
+		if (database->thread_sessions)
+		{
+			DBConnectionInfo::ThreadSession *session_ptr = getThreadSession(database);
+			status = prepare(session_ptr->session, session_ptr->itr->second);
+		}
+		else
+		{
+			Poco::Data::Session session = database->pool->extDB_get(itr);
+			checked_out = true;
+			status = prepare(session, itr->second);
+		}
+	}
+	catch (Poco::Exception& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: Warmup: Error: " << e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::fatal) << "extDB: Warmup: Error: " << e.displayText();
+	}
+
+	boost::lock_guard<boost::mutex> lock(job->mutex);
+	if (checked_out)
+	{
+		if (job->timed_out)
+		{
+			database->pool->putBack(itr);
+		}
+		else
+		{
+			// Held till every Job finished, so other Jobs don't get the same DB Session
+			job->sessions.push_back(itr);
+		}
+	}
+	if (!status)
+	{
+		job->status = false;
+	}
+	++job->completed;
+	job->condition.notify_all();
+}
+
+
+void Ext::getPoolStats(char *output, const int &output_size, const std::string &database_name)
+// [1,[Checkouts,Waited,Rejected,Average Wait ms,Max Wait ms,Used,Idle,Allocated,Capacity,Waiting]]
+{
+	DBConnectionInfo *database = findDatabase(database_name);
+	if (database == nullptr)
+	{
+		std::strcpy(output, ("[0,\"Error No Database Connection\"]"));
+	}
+	else
+	{
+		Poco::Data::SessionPool::CheckoutStats stats = database->pool->extDB_getCheckoutStats();
+		Poco::Int64 avg_wait = 0;
+		if (stats.waited > 0)
+		{
+			avg_wait = (stats.totalWait / stats.waited) / 1000;
+		}
+		std::string result = "[1,[" + Poco::NumberFormatter::format(stats.checkouts) + "," +
+								Poco::NumberFormatter::format(stats.waited) + "," +
+								Poco::NumberFormatter::format(stats.rejected) + "," +
+								Poco::NumberFormatter::format(avg_wait) + "," +
+								Poco::NumberFormatter::format(stats.maxWait / 1000) + "," +
+								Poco::NumberFormatter::format(stats.used) + "," +
+								Poco::NumberFormatter::format(stats.idle) + "," +
+								Poco::NumberFormatter::format(stats.allocated) + "," +
+								Poco::NumberFormatter::format(stats.capacity) + "," +
+								Poco::NumberFormatter::format(stats.waiting) + "]]";
+		std::strcpy(output, result.c_str());
+	}
+}
+
+
+void Ext::getStatementStats(char *output, const int &output_size, const std::string &database_name)
+// [1,[Hits,Misses,Evictions,Prepared,Prepare Time ms,Hit Rate %,Prepare Time Saved ms]]
+//	Prepare Time Saved = Hits x Average Prepare Time
+{
+	DBConnectionInfo *database = findDatabase(database_name);
+	if (database == nullptr)
+	{
+		std::strcpy(output, ("[0,\"Error No Database Connection\"]"));
+	}
+	else
+	{
+		const Poco::Data::StatementCacheStats &stats = database->pool->extDB_getStatementStats();
+		const Poco::Int64 hits = stats.hits.load();
+		const Poco::Int64 misses = stats.misses.load();
+		const Poco::Int64 prepared = stats.prepared.load();
+		const Poco::Int64 prepare_time = stats.prepareTime.load();
+		const Poco::Int64 hit_rate = ((hits + misses) > 0) ? ((hits * 100) / (hits + misses)) : 0;
+		const Poco::Int64 time_saved = (prepared > 0) ? ((hits * (prepare_time / prepared)) / 1000) : 0;
+		std::string result = "[1,[" + Poco::NumberFormatter::format(hits) + "," +
+								Poco::NumberFormatter::format(misses) + "," +
+								Poco::NumberFormatter::format(stats.evictions.load()) + "," +
+								Poco::NumberFormatter::format(prepared) + "," +
+								Poco::NumberFormatter::format(prepare_time / 1000) + "," +
+								Poco::NumberFormatter::format(hit_rate) + "," +
+								Poco::NumberFormatter::format(time_saved) + "]]";
+		std::strcpy(output, result.c_str());
+	}
+}
+
+
+void Ext::getBatchStats(char *output, const int &output_size, const std::string &protocol_name)
+// [1,[Batches,Batched Calls,Average Batch Size,Max Batch Size,Query Time ms]] of Protocol
+{
+	const ProtocolEntry *entry = findProtocol(protocol_name);
+	if (entry == nullptr)
+	{
+		std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
+	}
+	else
+	{
+		std::string result;
+		entry->protocol->getBatchStats(result);
+		std::strcpy(output, result.c_str());
+	}
+}
+
+
+std::string Ext::getDBType(DBConnectionInfo *database)
+{
+	if (database == nullptr)
+	{
+		return "";
+	}
+	return database->db_type;
+}
+
+
+DBConnectionInfo *Ext::findDatabase(const std::string &database_name)
+// Config Section Name -> Database Connection, Empty Name = Default Database, nullptr if Not Connected
+{
+	if (database_name.empty())
+	{
+		return default_database;
+	}
+	std::unordered_map< std::string, boost::shared_ptr<DBConnectionInfo> >::const_iterator itr = databases.find(database_name);
+	if (itr == databases.end())
+	{
+		return nullptr;
+	}
+	return itr->second.get();
+}
+
+
+void Ext::getSinglePartResult_mutexlock(const int &unique_id, char *output, const int &output_size)
+// Gets Result String from unordered map array -- Result Formt == Single-Message
+//   If <=, then sends output to arma, and removes entry from unordered map array
+//   If >, sends [5] to indicate MultiPartResult
+{
+	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+	std::unordered_map<int, std::string>::const_iterator it = unordered_map_results.find(unique_id);
+	if (it == unordered_map_results.end()) // NO UNIQUE ID or WAIT
+	{
+		if (unordered_map_wait.count(unique_id) == 0)
+		{
+			std::strcpy(output, (""));
+		}
+		else
+		{
+			std::strcpy(output, ("[3]"));
+		}
+	}
+	else if (unordered_map_wait.count(unique_id) != 0) // Streamed Result, Call still running
+	{
+		std::strcpy(output, ("[3]"));
+	}
+	else // SEND MSG (Part)
+	{
+		if (it->second.length() > output_size)
+		{
+			std::strcpy(output, ("[5]"));
+		}
+		else
+		{
+			std::string msg = it->second.substr(0, output_size);
+			std::strcpy(output, msg.c_str());
+			unordered_map_results.erase(unique_id);
+			freeUniqueID_mutexlock(unique_id);
+		}
+	}
+}
+
+
+void Ext::getMultiPartResult_mutexlock(const int &unique_id, char *output, const int &output_size)
+// Gets Result String from unordered map array  -- Result Format = Multi-Message 
+//   If length of String = 0, sends arma "", and removes entry from unordered map array
+//   If <=, then sends output to arma
+//   If >, then sends 1 part to arma + stores rest.
+{
+	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+	std::unordered_map<int, std::string>::const_iterator it = unordered_map_results.find(unique_id);
+	if (it == unordered_map_results.end()) // NO UNIQUE ID or WAIT
+	{
+		if (unordered_map_wait.count(unique_id) == 0)
+		{
+			std::strcpy(output, (""));
+		}
+		else
+		{
+			std::strcpy(output, ("[3]"));
+		}
+	}
+	else if (it->second.empty()) // END of MSG
+	{
+		if (unordered_map_wait.count(unique_id) == 0)
+		{
+			unordered_map_results.erase(unique_id);
+			freeUniqueID_mutexlock(unique_id);
+			std::strcpy(output, (""));
+		}
+		else
+		{
+			// Streamed Result, Client is ahead of Call
+			std::strcpy(output, ("[3]"));
+		}
+	}
+	else // SEND MSG (Part)
+	{
+		std::string msg = it->second.substr(0, output_size);
+		std::strcpy(output, msg.c_str());
+		if (it->second.length() > output_size)
+		{
+			unordered_map_results[unique_id] = it->second.substr(output_size);
+		}
+		else
+		{
+			unordered_map_results[unique_id].clear();
+		}
+		condition_unordered_map_results.notify_all();
+	}
+}
+
+
+void Ext::saveResult_mutexlock(const std::string &result, const int &unique_id)
+// Stores Result String  in a unordered map array.
+//   Used when string > arma output char
+{
+	boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+	unordered_map_results[unique_id] = "[1," + result + "]";
+	unordered_map_wait.erase(unique_id);
+}
+
+
+void Ext::publishStream_mutexlock(std::string &result, const int &unique_id, const bool &first)
+// Moves Streamed Rows into Result Slot + clears result, Client fetches them with 5:ID while Call is still running
+//   Waits while Client has Stream Buffer Size left to fetch, throws Poco::TimeoutException after Stream Timeout
+{
+	boost::unique_lock<boost::mutex> lock(mutex_unordered_map_results);
+	if (!condition_unordered_map_results.wait_for(lock, boost::chrono::milliseconds(stream_timeout), [this, &unique_id]{ return unordered_map_results[unique_id].size() < stream_buffer_size; }))
+	{
+		throw Poco::TimeoutException("extDB: Streamed Result not fetched");
+	}
+	if (first)
+	{
+		unordered_map_results[unique_id] = "[1," + result;
+	}
+	else
+	{
+		unordered_map_results[unique_id] += result;
+	}
+	result.clear();
+}
+
+
+void Ext::StreamJob::publish(std::string &result)
+{
+	extension->publishStream_mutexlock(result, unique_id, !published);
+	published = true;
+}
+
+
+void Ext::addProtocol(char *output, const int &output_size, const std::string &database_name, const std::string &protocol, const std::string &protocol_name, const std::string &init_data)
+{
+	if ((!protocol_name.empty()) && (protocol_name[0] == '#'))
+	{
+		// #Protocol Handle calls a Protocol by its Handle, see findProtocol
+		std::strcpy(output, "[0,\"Error Protocol Name can't start with #\"]");
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Error Protocol Name can't start with #: " << protocol_name;
+		return;
+	}
+
+	boost::lock_guard<boost::mutex> lock(mutex_protocol_registry);
+
+	boost::shared_ptr<AbstractProtocol> protocol_ptr;
+	bool database_protocol = true;
+	if (boost::iequals(protocol, std::string("MISC")) == 1)
+	{
+		protocol_ptr.reset(new MISC());
+		database_protocol = false;
+	}
+	else if (boost::iequals(protocol, std::string("LOG")) == 1)
+	{
+		protocol_ptr.reset(new LOG());
+		database_protocol = false;
+	}
+	else if (boost::iequals(protocol, std::string("DB_CUSTOM_V3")) == 1)
+	{
+		protocol_ptr.reset(new DB_CUSTOM_V3());
+	}
+	else if (boost::iequals(protocol, std::string("DB_CUSTOM_V5")) == 1)
+	{
+		protocol_ptr.reset(new DB_CUSTOM_V5());
+	}
+	else if (boost::iequals(protocol, std::string("DB_RAW_V2")) == 1)
+	{
+		protocol_ptr.reset(new DB_RAW_V3("DB_RAW_V2", NativePool::QUOTE_STRINGS | NativePool::QUOTE_EMPTY, 0));
+	}
+	else if (boost::iequals(protocol, std::string("DB_RAW_NO_EXTRA_QUOTES_V2")) == 1)
+	{
+		protocol_ptr.reset(new DB_RAW_V3("DB_RAW_NO_EXTRA_QUOTES_V2", NativePool::QUOTE_EMPTY, 0));
+	}
+	else if (boost::iequals(protocol, std::string("DB_RAW_V3")) == 1)
+	{
+		protocol_ptr.reset(new DB_RAW_V3("DB_RAW_V3", 0, DB_RAW_V3::ADD_QUOTES_INIT));
+	}
+	else if (boost::iequals(protocol, std::string("DB_RAW_PARAMS_V3")) == 1)
+	{
+		protocol_ptr.reset(new DB_RAW_V3("DB_RAW_PARAMS_V3", 0, DB_RAW_V3::ADD_QUOTES_INIT | DB_RAW_V3::PARAMS));
+	}
+	else if (boost::iequals(protocol, std::string("DB_PROCEDURE_V2")) == 1)
+	{
+		protocol_ptr.reset(new DB_PROCEDURE_V2());
+	}
+
+	// Database Connection of Protocol, 9:ADD uses Default Database
+	DBConnectionInfo *database = findDatabase(database_name);
+	if (protocol_ptr && database_protocol)
+	{
+		protocol_ptr->database = database;
+	}
+
+	if (!protocol_ptr)
+	{
+		std::strcpy(output, "[0,\"Error Unknown Protocol\"]");
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Error Unknown Protocol";
+	}
+	else if ((!database_name.empty()) && (database == nullptr))
+	{
+		std::strcpy(output, "[0,\"Error Unknown Database\"]");
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Error Unknown Database: " << database_name;
+	}
+	else if (!protocol_ptr->init(this, init_data))
+	// Don't Add Class Instance if Failed to Load
+	{
+		std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
+	}
+	else
+	{
+		ProtocolEntry entry;
+		entry.name = protocol_name;
+		entry.protocol = protocol_ptr;
+		// Journal Key, Protocol Names are randomized each start (sqf/init.sqf) so Journal left over from last run can't use them
+		entry.journal_key = boost::to_upper_copy(protocol) + ":" + ((database != nullptr) ? database->name : "") + ":" + init_data;
+
+		// Sync Latency Budget, Protocol Name Option -> Protocol Option -> Main Option
+		entry.sync_budget = pConf->getInt(("Sync Latency Budget." + protocol_name), pConf->getInt(("Sync Latency Budget." + boost::to_upper_copy(protocol)), sync_latency_budget));
+		if ((sync_hard_timeout > 0) && ((entry.sync_budget <= 0) || (entry.sync_budget > sync_hard_timeout)))
+		{
+			entry.sync_budget = sync_hard_timeout;
+		}
+		if (entry.sync_budget > 0)
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Sync Latency Budget: " << protocol_name << ": " << entry.sync_budget << "ms";
+		}
+
+		// Copy current Registry, Re-Adding a Protocol Name keeps its Protocol Handle
+		boost::shared_ptr<ProtocolRegistry> registry(new ProtocolRegistry(*protocol_registry.load()));
+		int protocol_handle;
+		std::unordered_map< std::string, int >::const_iterator handle_itr = registry->handles.find(protocol_name);
+		if (handle_itr == registry->handles.end())
+		{
+			protocol_handle = registry->protocols.size();
+			registry->protocols.push_back(entry);
+			registry->handles[protocol_name] = protocol_handle;
+		}
+		else
+		{
+			protocol_handle = handle_itr->second;
+			const std::string old_journal_key = registry->protocols[protocol_handle].journal_key;
+			std::unordered_map< std::string, int >::iterator journal_itr = registry->journal_handles.find(old_journal_key);
+			registry->protocols[protocol_handle] = entry;
+			if ((journal_itr != registry->journal_handles.end()) && (journal_itr->second == protocol_handle))
+			{
+				// Old Journal Key moves to another Protocol Name with the same Journal Key, if any
+				registry->journal_handles.erase(journal_itr);
+				for (std::size_t i = 0; i < registry->protocols.size(); ++i)
+				{
+					if (registry->protocols[i].journal_key == old_journal_key)
+					{
+						registry->journal_handles[old_journal_key] = i;
+						break;
+					}
+				}
+			}
+		}
+		registry->journal_handles[entry.journal_key] = protocol_handle;
+		protocol_registry_snapshots.push_back(registry);
+		protocol_registry.store(registry.get());
+
+		std::strcpy(output, ("[1," + Poco::NumberFormatter::format(protocol_handle) + "]").c_str());
+	}
+}
+
+
+const Ext::ProtocolEntry *Ext::findProtocol(const std::string &protocol)
+// Protocol Name or #Protocol Handle -> Protocol Entry, nullptr if Unknown Protocol
+{
+	const ProtocolRegistry *registry = protocol_registry.load();
+	if ((!protocol.empty()) && (protocol[0] == '#'))
+	{
+		int protocol_handle;
+		if ((Poco::NumberParser::tryParse(protocol.substr(1), protocol_handle)) && (protocol_handle >= 0) && (static_cast<std::size_t>(protocol_handle) < registry->protocols.size()))
+		{
+			return &(registry->protocols[protocol_handle]);
+		}
+	}
+	else
+	{
+		std::unordered_map< std::string, int >::const_iterator itr = registry->handles.find(protocol);
+		if (itr != registry->handles.end())
+		{
+			return &(registry->protocols[itr->second]);
+		}
+	}
+	return nullptr;
+}
+
+
+void Ext::syncCallProtocol(char *output, const int &output_size, const std::string &protocol, const std::string &data)
+// Sync callPlugin
+{
+	const ProtocolEntry *entry = findProtocol(protocol);
+	if (entry == nullptr)
+	{
+		std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Unknown Protocol: " + protocol);
+	}
+	else
+	{
+		std::string result;
+		result.reserve(2000);
+
+		const int sync_budget = entry->sync_budget;
+		if (circuitOpen(entry->protocol))
+		{
+			result = "[0,\"Error Database Unavailable\"]";
+		}
+		else if (sync_budget <= 0)
+		{
+			SyncThread::mark();
+			runProtocol(entry->protocol, data, result, nullptr);
+		}
+		else
+		{
+			// Run on Worker Thread, only wait on it for the Latency Budget
+			//   If finished in time, same as normal Sync Call
+			//   If not, returns ID Message to arma + Worker Thread stores result (same as ASYNC + SAVE)
+			const int unique_id = getUniqueID_mutexlock();
+			{
+				boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+				unordered_map_wait[unique_id] = true;
+			}
+
+			boost::shared_ptr<SyncJob> job(new SyncJob);
+			io_service.post(boost::bind(&Ext::syncJobCallProtocol, this, entry->protocol, data, unique_id, job));
+
+			boost::unique_lock<boost::mutex> lock(job->mutex);
+			if (!job->condition.wait_for(lock, boost::chrono::milliseconds(sync_budget), [&job]{ return job->completed; }))
+			{
+				job->promoted = true;
+				std::strcpy(output, ("[2,\"" + Poco::NumberFormatter::format(unique_id) + "\"]").c_str());
+				#ifdef DEBUG_LOGGING
+					BOOST_LOG_SEV(logger, boost::log::trivial::trace) << "extDB: Sync Latency Budget Exceeded: " + protocol + ": ID: " + Poco::NumberFormatter::format(unique_id);
+				#endif
+				return;
+			}
+			result = std::move(job->result);
+			lock.unlock();
+
+			{
+				boost::lock_guard<boost::mutex> lock_results(mutex_unordered_map_results);
+				unordered_map_wait.erase(unique_id);
+			}
+			freeUniqueID_mutexlock(unique_id);
+		}
+
+		// Checks if Result String will fit into arma output char
+		//   If <=, then sends output to arma
+		//   if >, then sends ID Message arma + stores rest. (mutex locks)
+		if (result.length() <= (output_size-6))
+		{
+			std::strcpy(output, ("[1, " + result + "]").c_str());
+		}
+		else
+		{
+			const int unique_id = getUniqueID_mutexlock();
+			saveResult_mutexlock(result, unique_id);
+			std::strcpy(output, ("[2,\"" + Poco::NumberFormatter::format(unique_id) + "\"]").c_str());
+		}
+	}
+}
+
+
+void Ext::runProtocol(const boost::shared_ptr<AbstractProtocol> &protocol, const std::string &data, std::string &result, ResultStream *stream)
+// callProtocol with a last resort catch, an Exception a Protocol didn't handle must not end a Worker Thread / the Arma Server
+{
+	try
+	{
+		protocol->callProtocol(this, data, result, stream);
+	}
+	catch (boost::thread_interrupted&)
+	{
+		throw;
+	}
+	catch (Poco::Exception& e)
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Error Unhandled Exception: " << e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Error Unhandled Exception: " << e.displayText() << " Input: " << data;
+		result = "[0,\"Error Exception\"]";
+	}
+	catch (std::exception& e)
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Error Unhandled Exception: " << e.what() << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Error Unhandled Exception: " << e.what() << " Input: " << data;
+		result = "[0,\"Error Exception\"]";
+	}
+	catch (...)
+	{
+		#ifdef TESTING
+			std::cout << "extDB: Error Unhandled Exception" << std::endl;
+		#endif
+		BOOST_LOG_SEV(logger, boost::log::trivial::error) << "extDB: Error Unhandled Exception, Input: " << data;
+		result = "[0,\"Error Exception\"]";
+	}
+}
+
+
+void Ext::syncJobCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id, boost::shared_ptr<SyncJob> job)
+// Sync callProtocol with Latency Budget, running on Worker Thread
+{
+	std::string result;
+	result.reserve(2000);
+	if (circuitOpen(protocol))
+	{
+		result = "[0,\"Error Database Unavailable\"]";
+	}
+	else
+	{
+		runProtocol(protocol, data, result, nullptr);
+	}
+
+	boost::lock_guard<boost::mutex> lock(job->mutex);
+	if (job->promoted)
+	{
+		// Game Thread gave up waiting + already returned ID to arma
+		saveResult_mutexlock(result, unique_id);
+	}
+	else
+	{
+		job->result = std::move(result);
+		job->completed = true;
+		job->condition.notify_one();
+	}
+}
+
+
+void Ext::onewayCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string journal_key, const std::string data)
+// ASync callProtocol
+//	Circuit Open = Call is added to Journal (if enabled) else dropped
+{
+	if (circuitOpen(protocol))
+	{
+		if (!journalCall(protocol->database, journal_key, data))
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Database Unavailable, Dropped Call: " << journal_key << ": " << data;
 		}
-		else if (boost::iequals(protocol, std::string("LOG")) == 1)
+		return;
+	}
+	std::string result;
+	result.reserve(2000);
+	runProtocol(protocol, data, result, nullptr);
+}
+
+
+void Ext::asyncCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id)
+// ASync + Save callProtocol
+// Protocol is looked up before Job is added to Work Queue
+{
+	std::string result;
+	result.reserve(2000);
+	if (circuitOpen(protocol))
+	{
+		result = "[0,\"Error Database Unavailable\"]";
+	}
+	else
+	{
+		runProtocol(protocol, data, result, nullptr);
+	}
+	saveResult_mutexlock(result, unique_id);
+}
+
+
+void Ext::asyncStreamCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id)
+// ASync + Save callProtocol, Result is streamed (6:)
+//   Rows already published stay in Result Slot, rest of Result is added once Call is done
+//   Joined Result = [1,RESULT], Error after Rows were published closes the Rows + is added as last Element [1,[1,[ROWS]],[0,"Error ..."]]
+{
+	std::string result;
+	result.reserve(stream_chunk_size + 2000);
+	StreamJob stream(this, unique_id, stream_chunk_size);
+	if (circuitOpen(protocol))
+	{
+		result = "[0,\"Error Database Unavailable\"]";
+	}
+	else
+	{
+		runProtocol(protocol, data, result, &stream);
+	}
+
+	if (!stream.published)
+	{
+		saveResult_mutexlock(result, unique_id);
+	}
+	else
+	{
+		if (!boost::algorithm::ends_with(result, "]]"))
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new LOG());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
-			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
-			}
-			else
-			{
-				std::strcpy(output, "[1]");
-			}
+			// Rest of a Result always ends with ]], anything else is an Error
+			result = "]]," + result;
 		}
-		else if (boost::iequals(protocol, std::string("DB_CUSTOM_V3")) == 1)
+		boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+		unordered_map_results[unique_id] += result + "]";
+		unordered_map_wait.erase(unique_id);
+	}
+}
+
+
+void Ext::openCursorCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id)
+// ASync + Save, opens Cursor + saves first Page
+{
+	std::string result;
+	result.reserve(2000);
+	if (circuitOpen(protocol))
+	{
+		result = "[0,\"Error Database Unavailable\"]";
+	}
+	else
+	{
+		boost::shared_ptr<CursorEntry> entry(new CursorEntry());
+		int cursor_id = 0;
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new DB_CUSTOM_V3());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
-			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
-			}
-			else
+			boost::lock_guard<boost::mutex> lock(mutex_cursors);
+			if ((max_cursors == 0) || (cursors.size() < max_cursors))
 			{
-				std::strcpy(output, "[1]");
+				cursor_id = ++last_cursor_id;
+				entry->busy = true;
+				cursors[cursor_id] = entry;
 			}
 		}
-		else if (boost::iequals(protocol, std::string("DB_CUSTOM_V5")) == 1)
+		if (cursor_id == 0)
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new DB_CUSTOM_V5());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
-			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
-			}
-			else
-			{
-				std::strcpy(output, "[1]");
-			}
+			result = "[0,\"Error Max Cursors\"]";
 		}
-		else if (boost::iequals(protocol, std::string("DB_RAW_V2")) == 1)
+		else
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new DB_RAW_V2());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
-			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
-			}
-			else
-			{
-				std::strcpy(output, "[1]");
-			}
+			fetchCursor(entry, protocol, data, cursor_id, result);
 		}
-		else if (boost::iequals(protocol, std::string("DB_RAW_NO_EXTRA_QUOTES_V2")) == 1)
+	}
+	saveResult_mutexlock(result, unique_id);
+}
+
+
+void Ext::fetchCursorCallProtocol(boost::shared_ptr<CursorEntry> entry, const int cursor_id, const int unique_id)
+// ASync + Save, saves next Page of Cursor
+{
+	std::string result;
+	result.reserve(2000);
+	fetchCursor(entry, boost::shared_ptr<AbstractProtocol>(), "", cursor_id, result);
+	saveResult_mutexlock(result, unique_id);
+}
+
+
+void Ext::fetchCursor(boost::shared_ptr<CursorEntry> entry, boost::shared_ptr<AbstractProtocol> protocol, const std::string &data, const int &cursor_id, std::string &result)
+// Opens Cursor first if protocol is set, Next Page as [1,[ROWS],"CURSOR_ID"] or [1,[ROWS]] once all Rows were fetched
+//   Cursor is closed after its last Page or an Error
+{
+	bool close = true;
+	{
+		boost::lock_guard<boost::mutex> lock(entry->mutex);
+		try
 		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new DB_RAW_NO_EXTRA_QUOTES_V2());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
-			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
-			}
-			else
+			if (protocol)
 			{
-				std::strcpy(output, "[1]");
+				entry->cursor = protocol->openCursor(this, data, cursor_page_size, result);
 			}
-		}
-		else if (boost::iequals(protocol, std::string("DB_PROCEDURE_V2")) == 1)
-		{
-			unordered_map_protocol[protocol_name] = boost::shared_ptr<AbstractProtocol> (new DB_PROCEDURE_V2());
-			if (!unordered_map_protocol[protocol_name].get()->init(this, init_data))
-			// Remove Class Instance if Failed to Load
+			else if (!entry->cursor)
 			{
-				unordered_map_protocol.erase(protocol_name);
-				std::strcpy(output, "[0,\"Failed to Load Protocol\"]");
-				BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Failed to Load Protocol";
+				// Closed by 8:CURSOR_ID:CLOSE while waiting for Worker Thread
+				result = "[0,\"Error Unknown Cursor\"]";
 			}
-			else
+
+			if (entry->cursor)
 			{
-				std::strcpy(output, "[1]");
+				std::string page;
+				if (!entry->cursor->fetch(page))
+				{
+					result = "[0,\"Error Values Input is not sanitized\"]";
+				}
+				else if (entry->cursor->done())
+				{
+					result = "[1," + page + "]";
+				}
+				else
+				{
+					result = "[1," + page + ",\"" + Poco::NumberFormatter::format(cursor_id) + "\"]";
+					close = false;
+				}
 			}
 		}
-		else
+		catch (Poco::Data::SQLite::DBLockedException& e)
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Cursor: Error DBLockedException: " + e.displayText();
+			result = "[0,\"Error DBLocked Exception\"]";
+		}
+		catch (Poco::Data::MySQL::ConnectionException& e)
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Cursor: Error ConnectionException: " + e.displayText();
+			result = "[0,\"Error Connection Exception\"]";
+		}
+		catch (Poco::Data::MySQL::StatementException& e)
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Cursor: Error StatementException: " + e.displayText();
+			result = "[0,\"Error Statement Exception\"]";
+		}
+		catch (Poco::Data::DataException& e)
+		{
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Cursor: Error DataException: " + e.displayText();
+			result = "[0,\"Error Data Exception\"]";
+		}
+		catch (Poco::Exception& e)
 		{
-			std::strcpy(output, "[0,\"Error Unknown Protocol\"]");
-			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Error Unknown Protocol";
+			BOOST_LOG_SEV(logger, boost::log::trivial::warning) << "extDB: Cursor: Error Exception: " + e.displayText();
+			result = "[0,\"Error Exception\"]";
 		}
+		if (close)
+		{
+			entry->cursor.reset();
+		}
+	}
+
+	boost::lock_guard<boost::mutex> lock(mutex_cursors);
+	if (close)
+	{
+		cursors.erase(cursor_id);
+	}
+	else
+	{
+		entry->busy = false;
+		entry->last_used.update();
 	}
 }
 
 
-void Ext::syncCallProtocol(char *output, const int &output_size, const std::string &protocol, const std::string &data)
-// Sync callPlugin
+void Ext::closeCursor(boost::shared_ptr<CursorEntry> entry)
+// Runs on Worker Thread, MySQL reads rest of an unbuffered Result Set when Statement is closed
+{
+	boost::lock_guard<boost::mutex> lock(entry->mutex);
+	entry->cursor.reset();
+}
+
+
+void Ext::callCursor(char *output, const int &output_size, const std::string &input_str)
+// 8:CURSOR_ID = Next Page, returns [2,"ID"] same as 2:
+// 8:CURSOR_ID:CLOSE = Closes Cursor, returns [1]
 {
-	std::unordered_map< std::string, boost::shared_ptr<AbstractProtocol> >::const_iterator itr = unordered_map_protocol.find(protocol);
-	if (itr == unordered_map_protocol.end())
+	Poco::StringTokenizer tokens(input_str, ":");
+	int cursor_id;
+	if ((tokens.count() < 2) || (tokens.count() > 3) || (!Poco::NumberParser::tryParse(tokens[1], cursor_id)) ||
+		((tokens.count() == 3) && (tokens[2] != "CLOSE")))
 	{
-		std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
-		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Unknown Protocol: " + protocol);
+		std::strcpy(output, ("[0,\"Error Invalid Format\"]"));
+		BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Invalid Format: " + input_str);
+		return;
 	}
-	else
+
+	boost::shared_ptr<CursorEntry> entry;
+	bool busy = false;
 	{
-		// Checks if Result String will fit into arma output char
-		//   If <=, then sends output to arma
-		//   if >, then sends ID Message arma + stores rest. (mutex locks)
-		std::string result;
-		result.reserve(2000);
-		itr->second->callProtocol(this, data, result);
-		if (result.length() <= (output_size-6))
+		boost::lock_guard<boost::mutex> lock(mutex_cursors);
+		std::unordered_map< int, boost::shared_ptr<CursorEntry> >::iterator itr = cursors.find(cursor_id);
+		if (itr != cursors.end())
 		{
-			std::strcpy(output, ("[1, " + result + "]").c_str());
+			entry = itr->second;
+			if (tokens.count() == 3)
+			{
+				cursors.erase(itr);
+			}
+			else if (entry->busy)
+			{
+				busy = true;
+			}
+			else
+			{
+				entry->busy = true;
+			}
 		}
-		else
+	}
+
+	if (!entry)
+	{
+		std::strcpy(output, ("[0,\"Error Unknown Cursor\"]"));
+	}
+	else if (tokens.count() == 3)
+	{
+		io_service.post(boost::bind(&Ext::closeCursor, this, entry));
+		std::strcpy(output, ("[1]"));
+	}
+	else if (busy)
+	{
+		std::strcpy(output, ("[0,\"Error Cursor Busy\"]"));
+	}
+	else
+	{
+		int unique_id = getUniqueID_mutexlock();
 		{
-			const int unique_id = getUniqueID_mutexlock();
-			saveResult_mutexlock(result, unique_id);
-			std::strcpy(output, ("[2,\"" + Poco::NumberFormatter::format(unique_id) + "\"]").c_str());
+			boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+			unordered_map_wait[unique_id] = true;
 		}
+		io_service.post(boost::bind(&Ext::fetchCursorCallProtocol, this, entry, cursor_id, unique_id));
+		std::strcpy(output, (("[2,\"" + Poco::NumberFormatter::format(unique_id) + "\"]")).c_str());
 	}
 }
 
 
-void Ext::onewayCallProtocol(const std::string protocol, const std::string data)
-// ASync callProtocol
+void Ext::onCursorTimer(const boost::system::error_code &error)
+// Closes Cursors that weren't used for Cursor Idle Timeout, Cursor + its DB Session are freed on Worker Thread
 {
-	std::unordered_map< std::string, boost::shared_ptr<AbstractProtocol> >::const_iterator itr = unordered_map_protocol.find(protocol);
-	if (itr != unordered_map_protocol.end())
+	if (error)
 	{
-		std::string result;
-		result.reserve(2000);
-		itr->second->callProtocol(this, data, result);
+		// Timer Cancelled -- stop()
+		return;
 	}
-}
 
+	std::vector< boost::shared_ptr<CursorEntry> > idle_cursors;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex_cursors);
+		for (std::unordered_map< int, boost::shared_ptr<CursorEntry> >::iterator itr = cursors.begin(); itr != cursors.end();)
+		{
+			if ((!itr->second->busy) && itr->second->last_used.isElapsed(((Poco::Timestamp::TimeDiff) cursor_idle_timeout) * 1000))
+			{
+				idle_cursors.push_back(itr->second);
+				itr = cursors.erase(itr);
+			}
+			else
+			{
+				++itr;
+			}
+		}
+	}
+	for (std::vector< boost::shared_ptr<CursorEntry> >::iterator itr = idle_cursors.begin(); itr != idle_cursors.end(); ++itr)
+	{
+		closeCursor(*itr);
+	}
+	if (!idle_cursors.empty())
+	{
+		BOOST_LOG_SEV(logger, boost::log::trivial::info) << "extDB: Closed Idle Cursors: " << idle_cursors.size();
+	}
 
-void Ext::asyncCallProtocol(const std::string protocol, const std::string data, const int unique_id)
-// ASync + Save callProtocol
-// We check if Protocol exists here, since its a thread (less time spent blocking arma) and it shouldnt happen anyways
-{
-	std::string result;
-	result.reserve(2000);
-	unordered_map_protocol[protocol].get()->callProtocol(this, data, result);
-	saveResult_mutexlock(result, unique_id);
+	cursor_timer->expires_from_now(boost::posix_time::milliseconds(cursor_idle_timeout / 2));
+	cursor_timer->async_wait(boost::bind(&Ext::onCursorTimer, this, boost::asio::placeholders::error));
 }
 
 
@@ -812,6 +2522,8 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 				switch (async)  // TODO Profile using Numberparser versus comparsion of char[0] + if statement checking length of *function
 				{
 					case 2: //ASYNC + SAVE
+					case 6: //ASYNC + SAVE + STREAM
+					case 7: //ASYNC + SAVE + CURSOR
 					{
 						// Protocol
 						const std::string::size_type found = input_str.find(sep_char,2);
@@ -832,30 +2544,36 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 							}
 							else
 							{
-								bool found_procotol = false;
-								// Data
-								std::string data = input_str.substr(found+1);
-								int unique_id = getUniqueID_mutexlock();
-
 								// Check for Protocol Name Exists...
 								// Do this so if someone manages to get server, the error message wont get stored in the result unordered map
+								const ProtocolEntry *entry = findProtocol(protocol);
+								if (entry == nullptr)
+								{
+									std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
+									BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Unknown Protocol: " + protocol);
+								}
+								else
 								{
-									boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
-									if (unordered_map_protocol.find(protocol) == unordered_map_protocol.end())
+									// Data
+									std::string data = input_str.substr(found+1);
+									int unique_id = getUniqueID_mutexlock();
 									{
-										std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
-										BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Unknown Protocol: " + protocol);
+										boost::lock_guard<boost::mutex> lock(mutex_unordered_map_results);
+										unordered_map_wait[unique_id] = true;
+									}
+									// Only Add Job to Work Queue + Return ID if Protocol Name exists.
+									if (async == 6)
+									{
+										io_service.post(boost::bind(&Ext::asyncStreamCallProtocol, this, entry->protocol, data, unique_id));
+									}
+									else if (async == 7)
+									{
+										io_service.post(boost::bind(&Ext::openCursorCallProtocol, this, entry->protocol, data, unique_id));
 									}
 									else
 									{
-										unordered_map_wait[unique_id] = true;
-										found_procotol = true;
+										io_service.post(boost::bind(&Ext::asyncCallProtocol, this, entry->protocol, data, unique_id));
 									}
-								}
-								// Only Add Job to Work Queue + Return ID if Protocol Name exists.
-								if (found_procotol)
-								{
-									io_service.post(boost::bind(&Ext::asyncCallProtocol, this, protocol, data, unique_id));
 									std::strcpy(output, (("[2,\"" + Poco::NumberFormatter::format(unique_id) + "\"]")).c_str());
 								}
 							}
@@ -874,6 +2592,11 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 						getMultiPartResult_mutexlock(unique_id, output, output_size);
 						break;
 					}
+					case 8: // CURSOR -- Next Page / Close
+					{
+						callCursor(output, output_size, input_str);
+						break;
+					}
 					case 1: //ASYNC
 					{
 						// Protocol
@@ -894,10 +2617,23 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 							else
 							{
 								const std::string protocol = input_str.substr(2,(found-2));
-								// Data
-								const std::string data = input_str.substr(found+1);
-								io_service.post(boost::bind(&Ext::onewayCallProtocol, this, protocol, data));
-								std::strcpy(output, "[1]");
+								const ProtocolEntry *entry = findProtocol(protocol);
+								if (entry == nullptr)
+								{
+									std::strcpy(output, ("[0,\"Error Unknown Protocol\"]"));
+									BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Unknown Protocol: " + protocol);
+								}
+								else
+								{
+									// Data
+									const std::string data = input_str.substr(found+1);
+									// Write Journal, if Journal is full Call runs on Worker Thread as normal
+									if (!journalCall(entry->protocol->database, entry->journal_key, data))
+									{
+										io_service.post(boost::bind(&Ext::onewayCallProtocol, this, entry->protocol, entry->journal_key, data));
+									}
+									std::strcpy(output, "[1]");
+								}
 							}
 						}
 						break;
@@ -944,6 +2680,29 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 								{
 									std::strcpy(output, ("[1]"));
 								}
+								else if (tokens[1] == "POOL_STATS")
+								{
+									getPoolStats(output, output_size, "");
+								}
+								else if (tokens[1] == "STATEMENT_STATS")
+								{
+									getStatementStats(output, output_size, "");
+								}
+							}
+							else if (tokens.count() == 3)
+							{
+								if (tokens[1] == "POOL_STATS")
+								{
+									getPoolStats(output, output_size, tokens[2]);
+								}
+								else if (tokens[1] == "STATEMENT_STATS")
+								{
+									getStatementStats(output, output_size, tokens[2]);
+								}
+								else if (tokens[1] == "BATCH_STATS")
+								{
+									getBatchStats(output, output_size, tokens[2]);
+								}
 							}
 						}
 						else
@@ -966,6 +2725,14 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 									{
 										std::strcpy(output, ("[0]"));
 									}
+									else if (tokens[1] == "POOL_STATS")
+									{
+										getPoolStats(output, output_size, "");
+									}
+									else if (tokens[1] == "STATEMENT_STATS")
+									{
+										getStatementStats(output, output_size, "");
+									}
 									else if (tokens[1] == "OUTPUTSIZE")
 									{
 										std::string outputsize_str(Poco::NumberFormatter::format(output_size));
@@ -979,16 +2746,52 @@ void Ext::callExtenion(char *output, const int &output_size, const char *functio
 									}
 									break;
 								case 3:
-									// DATABASE
-									connectDatabase(output, output_size, tokens[2]);
+									// POOL_STATS / STATEMENT_STATS for Database
+									if (tokens[1] == "POOL_STATS")
+									{
+										getPoolStats(output, output_size, tokens[2]);
+									}
+									else if (tokens[1] == "STATEMENT_STATS")
+									{
+										getStatementStats(output, output_size, tokens[2]);
+									}
+									else if (tokens[1] == "BATCH_STATS")
+									{
+										getBatchStats(output, output_size, tokens[2]);
+									}
+									else
+									{
+										// DATABASE
+										connectDatabase(output, output_size, tokens[2]);
+									}
 									break;
 								case 4:
 									// ADD PROTOCOL
-									addProtocol(output, output_size, tokens[2], tokens[3], "");
+									addProtocol(output, output_size, "", tokens[2], tokens[3], "");
 									break;
 								case 5:
-									//ADD PROTOCOL
-									addProtocol(output, output_size, tokens[2], tokens[3], tokens[4]);
+									if (tokens[1] == "ADD_DATABASE_PROTOCOL")
+									{
+										// ADD PROTOCOL for Database
+										addProtocol(output, output_size, tokens[2], tokens[3], tokens[4], "");
+									}
+									else
+									{
+										//ADD PROTOCOL
+										addProtocol(output, output_size, "", tokens[2], tokens[3], tokens[4]);
+									}
+									break;
+								case 6:
+									if (tokens[1] == "ADD_DATABASE_PROTOCOL")
+									{
+										// ADD PROTOCOL for Database
+										addProtocol(output, output_size, tokens[2], tokens[3], tokens[4], tokens[5]);
+									}
+									else
+									{
+										std::strcpy(output, ("[0,\"Error Invalid Format\"]"));
+										BOOST_LOG_SEV(logger, boost::log::trivial::warning) << ("extDB: Invalid Format: " + input_str);
+									}
 									break;
 								default:
 									// Invalid Format
@@ -19,12 +19,17 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <boost/asio.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <Poco/Data/SessionPool.h>
 
+#include <atomic>
 #include <unordered_map>
+#include <vector>
 
+#include "journal.h"
 #include "uniqueid.h"
 
 #include "protocols/abstract_ext.h"
@@ -42,6 +47,8 @@ class DBPool : public Poco::Data::SessionPool
 		{
 		}
 	
+		std::vector<std::string> session_statements;  // Run on every new DB Session i.e SQLite PRAGMAs
+
 	protected:
 		void customizeSession (Poco::Data::Session& session);
 };
@@ -59,9 +66,12 @@ class Ext: public AbstractExt
 
 		Poco::AutoPtr<Poco::Util::IniFileConfiguration> pConf;
 
-		Poco::Data::Session getDBSession_mutexlock();
-		Poco::Data::Session getDBSessionCustom_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr);
-		void putbackDBSession_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr);
+		Poco::Data::Session getDBSession_mutexlock(DBConnectionInfo *database);
+		Poco::Data::Session getDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr);
+		void putbackDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr);
+		void invalidateDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::Session &session);
+		void invalidateDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr);
+		bool warmupDBSessions(DBConnectionInfo *database, const boost::function<bool (Poco::Data::Session &, Poco::Data::StatementLRUCache &)> &prepare, int timeout);
 
 
 
@@ -69,31 +79,37 @@ class Ext: public AbstractExt
 		void stop();
 
 		std::string getAPIKey();
-		std::string getDBType();
+		std::string getDBType(DBConnectionInfo *database);
 
 		int getUniqueID_mutexlock();
 		void freeUniqueID_mutexlock(const int &unique_id);
 
-		boost::mutex mutex_poco_cached_preparedStatements;  // Using Same Lock for Wait / Results / Plugins
-
 	private:
 		bool extDB_lock;
 		bool extDB_error_db_kill_server;
 		
 		int max_threads;
 
+		int sync_latency_budget;
+		int sync_hard_timeout;
+
+		std::size_t stream_chunk_size;
+		std::size_t stream_buffer_size;
+		int stream_timeout;
+
+		std::size_t cursor_page_size;
+		int cursor_idle_timeout;
+		std::size_t max_cursors;
+
 		std::string extDB_path;
 		std::string steam_api_key;
 		
-		struct DBConnectionInfo {
-			std::string db_type;
-			std::string connection_str;
-			int min_sessions;
-			int max_sessions;
-			int idle_time;
-		};
-		
-		DBConnectionInfo db_conn_info;
+		// Database Connections -- Config Section Name -> Database Connection
+		//   Only changed by 9:DATABASE, Protocols keep a pointer to their Database Connection
+		//   First connected Database is used by 9:ADD
+		std::unordered_map< std::string, boost::shared_ptr<DBConnectionInfo> > databases;
+		DBConnectionInfo *default_database;
+		DBConnectionInfo *findDatabase(const std::string &database_name);
 
 		// ASIO Thread Queue
 		boost::shared_ptr<boost::asio::io_service::work> io_work_ptr;
@@ -102,24 +118,123 @@ class Ext: public AbstractExt
 
 		boost::thread_group threads;
 
-		// Database Session Pool
-		boost::shared_ptr<DBPool> db_pool;
-		boost::mutex mutex_db_pool;
+		DBConnectionInfo::ThreadSession *getThreadSession(DBConnectionInfo *database);
+
+		// Warmup -- Each Job opens its own DB Session on a Worker Thread
+		//   Warmed DB Sessions are handed to the Job + put back once every Job finished, so each Job warms a different DB Session
+		struct WarmupJob {
+			boost::mutex mutex;
+			boost::condition_variable condition;
+			unsigned int completed = 0;
+			bool status = true;
+			bool timed_out = false;  // Jobs finishing after the Timeout put their DB Session back themselves
+			std::vector< Poco::Data::SessionPool::SessionList::iterator > sessions;
+		};
+		void warmupDBSession(DBConnectionInfo *database, boost::shared_ptr<WarmupJob> job, boost::function<bool (Poco::Data::Session &, Poco::Data::StatementLRUCache &)> prepare);
 
 		void connectDatabase(char *output, const int &output_size, const std::string &conf_option);
+		void connectReplica(DBConnectionInfo *database, const std::string &conf_option);
+		void connectSQLiteReaders(DBConnectionInfo *database, int readers, bool thread_sessions, std::vector<std::string> session_statements);
+		boost::shared_ptr<DBConnectionInfo> connectSQLiteShard(DBConnectionInfo *database, const std::string &shard_name, int readers, bool reader_thread_sessions, const std::vector<std::string> &session_statements);
+		void connectMySQLNative(DBConnectionInfo *database, const std::string &conf_option);
+		void connectSQLiteNative(DBConnectionInfo *database, const std::string &conf_option, const std::vector<std::string> &session_statements);
+
+		// Read Replica Health Check -- One Thread per Replica, checks Replica Lag every Replica Check Interval
+		//   Checking on own Thread, so a Replica that is down never blocks Worker Threads
+		boost::thread_group replica_monitor_threads;
+		bool checkReplica(DBConnectionInfo *database);
+		void replicaMonitor(DBConnectionInfo *database);
+
+		// Circuit Breaker -- One Thread per Database, sleeps till Circuit opens then probes Database
+		//   Probing on own Thread, so a Database that is down never blocks Worker Threads
+		boost::thread_group circuit_breaker_threads;
+		void startCircuitBreaker(DBConnectionInfo *database, const std::string &conf_option);
+		void circuitBreaker(DBConnectionInfo *database);
+		bool probeDatabase(DBConnectionInfo *database);
+		void recordDBFailure(DBConnectionInfo *database);
+		void recordNativeStatus(DBConnectionInfo *database, bool connected);
+		bool circuitOpen(const boost::shared_ptr<AbstractProtocol> &protocol);
+
+		// Write Journal -- One Thread per Database drains its Journal
+		boost::thread_group journal_threads;
+		void startJournal(DBConnectionInfo *database, const std::string &conf_option);
+		bool journalCall(DBConnectionInfo *database, const std::string &protocol_key, const std::string &data);
+		void drainJournal(DBConnectionInfo *database);
+		void getPoolStats(char *output, const int &output_size, const std::string &database_name);
+		void getStatementStats(char *output, const int &output_size, const std::string &database_name);
+		void getBatchStats(char *output, const int &output_size, const std::string &protocol_name);
 
 		void getSinglePartResult_mutexlock(const int &unique_id, char *output, const int &output_size);
 		void getMultiPartResult_mutexlock(const int &unique_id, char *output, const int &output_size);
 		void sendResult_mutexlock(const std::string &result, char *output, const int &output_size);
 
-		// std::unordered_map + mutex -- for Plugin Loaded
-		std::unordered_map< std::string, boost::shared_ptr<AbstractProtocol> > unordered_map_protocol;
-		boost::mutex mutex_unordered_map_protocol;
+		// Protocol Registry -- Copy-on-Write Snapshots
+		//   Readers load current snapshot without a lock, snapshot is never modified after it is published
+		//   addProtocol copies current snapshot, modifies copy + publishes it (mutex lock)
+		//   Old snapshots are kept till stop(), so readers never see a freed snapshot
+		struct ProtocolEntry {
+			std::string name;
+			std::string journal_key;  // Protocol Type:Database:Init Data, Journal Entries are keyed by it
+			boost::shared_ptr<AbstractProtocol> protocol;
+			int sync_budget;  // Sync Latency Budget (milliseconds), 0 = Disabled
+		};
+
+		struct ProtocolRegistry {
+			std::vector< ProtocolEntry > protocols;  // Protocol Handle = Index
+			std::unordered_map< std::string, int > handles;  // Protocol Name -> Protocol Handle
+			std::unordered_map< std::string, int > journal_handles;  // Journal Key -> Protocol Handle
+		};
+
+		std::atomic<const ProtocolRegistry *> protocol_registry;
+		std::vector< boost::shared_ptr<const ProtocolRegistry> > protocol_registry_snapshots;
+		boost::mutex mutex_protocol_registry;
+
+		const ProtocolEntry *findProtocol(const std::string &protocol);
+		const ProtocolEntry *findJournalProtocol(std::unordered_map<std::string, const ProtocolEntry *> &protocols, const std::string &protocol_key);
+		void deadLetterJournal(DBConnectionInfo *database, const WriteJournal::Entry &entry, const std::string &reason);
+
+		// Shared between Sync Call + Worker Thread, when Sync Call has a Latency Budget
+		struct SyncJob {
+			boost::mutex mutex;
+			boost::condition_variable condition;
+			bool completed = false;
+			bool promoted = false;
+			std::string result;
+		};
 
 		// std::unordered_map + mutex -- for Stored Results to long for outputsize
 		std::unordered_map<int, bool> unordered_map_wait;
 		std::unordered_map<int, std::string> unordered_map_results;
 		boost::mutex mutex_unordered_map_results;  // Using Same Lock for Wait / Results / Plugins
+		boost::condition_variable condition_unordered_map_results;  // Client fetched part of a Streamed Result
+
+		// Streaming Result (6:) -- Published Rows go straight into Result Slot of unique_id
+		struct StreamJob: public ResultStream {
+			StreamJob(Ext *ext, int id, std::size_t chunk_size) : ResultStream(chunk_size), extension(ext), unique_id(id) {}
+			void publish(std::string &result);
+			Ext *extension;
+			int unique_id;
+			bool published = false;
+		};
+		void publishStream_mutexlock(std::string &result, const int &unique_id, const bool &first);
+
+		// Cursors (7: / 8:) -- Cursor keeps Statement + DB Session of a Call, Client fetches one Page per 8:
+		//   Cursor Timer closes Cursors that weren't used for Cursor Idle Timeout
+		struct CursorEntry {
+			boost::shared_ptr<ResultCursor> cursor;
+			boost::mutex mutex;  // One Page at a time
+			Poco::Timestamp last_used;  // mutex_cursors
+			bool busy = false;  // mutex_cursors, Page is being fetched
+		};
+		std::unordered_map< int, boost::shared_ptr<CursorEntry> > cursors;
+		int last_cursor_id;
+		boost::mutex mutex_cursors;
+		boost::shared_ptr<boost::asio::deadline_timer> cursor_timer;
+
+		void callCursor(char *output, const int &output_size, const std::string &input_str);
+		void fetchCursor(boost::shared_ptr<CursorEntry> entry, boost::shared_ptr<AbstractProtocol> protocol, const std::string &data, const int &cursor_id, std::string &result);
+		void closeCursor(boost::shared_ptr<CursorEntry> entry);
+		void onCursorTimer(const boost::system::error_code &error);
 
 
 
@@ -128,9 +243,14 @@ class Ext: public AbstractExt
 		boost::mutex mutex_unique_id;
 
 		// Protocols
-		void addProtocol(char *output, const int &output_size, const std::string &protocol, const std::string &protocol_name, const std::string &init_data);
+		void addProtocol(char *output, const int &output_size, const std::string &database_name, const std::string &protocol, const std::string &protocol_name, const std::string &init_data);
 
 		void syncCallProtocol(char *output, const int &output_size, const std::string &protocol, const std::string &data);
-		void onewayCallProtocol(const std::string protocol, const std::string data);
-		void asyncCallProtocol(const std::string protocol, const std::string data, const int unique_id);
+		void onewayCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string journal_key, const std::string data);
+		void asyncCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id);
+		void runProtocol(const boost::shared_ptr<AbstractProtocol> &protocol, const std::string &data, std::string &result, ResultStream *stream);
+		void asyncStreamCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id);
+		void openCursorCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id);
+		void fetchCursorCallProtocol(boost::shared_ptr<CursorEntry> entry, const int cursor_id, const int unique_id);
+		void syncJobCallProtocol(boost::shared_ptr<AbstractProtocol> protocol, const std::string data, const int unique_id, boost::shared_ptr<SyncJob> job);
 };
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "journal.h"
+
+#include <boost/chrono.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+
+namespace
+{
+	const char journal_magic[8] = {'e', 'x', 't', 'D', 'B', 'J', '0', '1'};
+	const std::size_t journal_header_size = 64;  // Header + Padding, keeps Entries 8 byte aligned
+	const std::size_t journal_min_size = 65536;
+
+	inline boost::uint64_t align8(boost::uint64_t size)
+	{
+		return (size + 7) & ~((boost::uint64_t) 7);
+	}
+}
+
+
+WriteJournal::WriteJournal() : header(nullptr), buffer(nullptr), capacity(0)
+{
+}
+
+
+WriteJournal::~WriteJournal()
+{
+	if (header != nullptr)
+	{
+		region.flush();
+	}
+}
+
+
+bool WriteJournal::open(const std::string &path, std::size_t size)
+// Maps Journal File, creates it if missing
+//	Existing Journal File keeps its Size so undrained Entries aren't lost
+{
+	try
+	{
+		size = align8(size);
+		if (size < journal_min_size)
+		{
+			size = journal_min_size;
+		}
+
+		if (boost::filesystem::exists(path) && (boost::filesystem::file_size(path) >= journal_min_size))
+		{
+			size = boost::filesystem::file_size(path);
+		}
+		else
+		{
+			std::filebuf fbuf;
+			fbuf.open(path.c_str(), std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+			fbuf.pubseekoff(size - 1, std::ios_base::beg);
+			fbuf.sputc(0);
+			fbuf.close();
+		}
+
+		dead_letter_path = path + ".deadletter";
+		boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_write).swap(file);
+		boost::interprocess::mapped_region(file, boost::interprocess::read_write, 0, size).swap(region);
+
+		header = static_cast<Header *>(region.get_address());
+		buffer = static_cast<char *>(region.get_address()) + journal_header_size;
+		capacity = (size - journal_header_size) & ~((boost::uint64_t) 7);
+
+		if ((std::memcmp(header->magic, journal_magic, sizeof(journal_magic)) != 0) ||
+			(header->capacity != capacity) ||
+			(header->head < header->tail) ||
+			((header->head - header->tail) > capacity))
+		{
+			// New or Corrupt Journal
+			std::memcpy(header->magic, journal_magic, sizeof(journal_magic));
+			header->capacity = capacity;
+			header->head = 0;
+			header->tail = 0;
+			region.flush(0, journal_header_size);
+		}
+		return true;
+	}
+	catch (boost::interprocess::interprocess_exception&)
+	{
+	}
+	catch (boost::filesystem::filesystem_error&)
+	{
+	}
+	header = nullptr;
+	buffer = nullptr;
+	return false;
+}
+
+
+bool WriteJournal::append(const std::string &protocol_key, const std::string &data)
+// Entry = EntryHeader + Protocol Key + Data, padded to 8 bytes
+//	Entry that doesn't fit before end of Ring Buffer, writes a Wrap Marker + starts at beginning
+{
+	const boost::uint64_t entry_size = align8(sizeof(EntryHeader) + protocol_key.size() + data.size());
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		boost::uint64_t head = header->head;
+		boost::uint64_t position = head % capacity;
+		boost::uint64_t skip = 0;
+		if (entry_size > (capacity - position))
+		{
+			skip = capacity - position;
+		}
+		if ((head - header->tail) + skip + entry_size > capacity)
+		{
+			return false;
+		}
+
+		if (skip > 0)
+		{
+			EntryHeader marker = {wrap_marker, 0};
+			std::memcpy(buffer + position, &marker, sizeof(EntryHeader));
+			head += skip;
+			position = 0;
+		}
+
+		EntryHeader entry_header = {(boost::uint32_t) protocol_key.size(), (boost::uint32_t) data.size()};
+		std::memcpy(buffer + position, &entry_header, sizeof(EntryHeader));
+		std::memcpy(buffer + position + sizeof(EntryHeader), protocol_key.data(), protocol_key.size());
+		std::memcpy(buffer + position + sizeof(EntryHeader) + protocol_key.size(), data.data(), data.size());
+
+		// Entry is written before Head moves past it
+		std::atomic_thread_fence(std::memory_order_release);
+		header->head = head + entry_size;
+	}
+	condition.notify_one();
+	return true;
+}
+
+
+bool WriteJournal::wait(int milliseconds)
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+	return condition.wait_for(lock, boost::chrono::milliseconds(milliseconds), [this]{ return header->head != header->tail; });
+}
+
+
+void WriteJournal::read(std::vector<Entry> &entries, std::size_t max_entries)
+// Copies up to max_entries undrained Entries, starting at Tail
+//	Entries between Tail + Head are never overwritten, so they are read without the lock
+{
+	boost::uint64_t offset;
+	boost::uint64_t head;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		offset = header->tail;
+		head = header->head;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	while ((offset < head) && (entries.size() < max_entries))
+	{
+		const boost::uint64_t position = offset % capacity;
+		EntryHeader entry_header;
+		std::memcpy(&entry_header, buffer + position, sizeof(EntryHeader));
+		if (entry_header.protocol_key_length == wrap_marker)
+		{
+			offset += (capacity - position);
+			continue;
+		}
+
+		Entry entry;
+		entry.protocol_key.assign(buffer + position + sizeof(EntryHeader), entry_header.protocol_key_length);
+		entry.data.assign(buffer + position + sizeof(EntryHeader) + entry_header.protocol_key_length, entry_header.data_length);
+		offset += align8(sizeof(EntryHeader) + entry_header.protocol_key_length + entry_header.data_length);
+		entry.next = offset;
+		entries.push_back(std::move(entry));
+	}
+}
+
+
+void WriteJournal::commit(boost::uint64_t offset)
+// Drained Entries up to offset, their space can be reused
+{
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		header->tail = offset;
+	}
+	region.flush(0, 0, true);
+}
+
+
+bool WriteJournal::deadLetter(const Entry &entry)
+// Calls that can't be run (Unknown Protocol / kept failing) are kept as PROTOCOL_TYPE:DATABASE:INIT_DATA:DATA Lines, one per Call
+{
+	std::ofstream dead_letter(dead_letter_path.c_str(), std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+	dead_letter << entry.protocol_key << ':' << entry.data << '\n';
+	dead_letter.flush();
+	return dead_letter.good();
+}
+
+
+boost::uint64_t WriteJournal::pending()
+// Bytes of undrained Entries
+{
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return header->head - header->tail;
+}
+
+
+void WriteJournal::notify()
+{
+	condition.notify_all();
+}
@@ -0,0 +1,83 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+
+class WriteJournal
+// Append-only Memory Mapped Journal for One-Way Calls, used as a Ring Buffer
+//	Game Thread appends Calls at memory speed, Drainer Thread reads them in Batches + commits once a Batch is done
+//	Entries between Tail + Head survive a crash / restart + are drained on next start
+{
+	public:
+		struct Entry {
+			std::string protocol_key;  // Protocol Type:Database:Init Data, Protocol Names change every restart
+			std::string data;
+			boost::uint64_t next;  // Journal Offset after this Entry, pass to commit()
+		};
+
+		WriteJournal();
+		~WriteJournal();
+
+		bool open(const std::string &path, std::size_t size);
+		bool append(const std::string &protocol_key, const std::string &data);  // false = Journal Full
+
+		bool wait(int milliseconds);  // Waits for Entries, false on timeout
+		void read(std::vector<Entry> &entries, std::size_t max_entries);
+		void commit(boost::uint64_t offset);
+		bool deadLetter(const Entry &entry);  // Appends Entry to <Journal>.deadletter
+
+		boost::uint64_t pending();
+		void notify();
+
+	private:
+		struct Header {
+			char magic[8];
+			boost::uint64_t capacity;
+			boost::uint64_t head;  // Journal Offset of next Entry, Journal Offsets only increase
+			boost::uint64_t tail;  // Journal Offset of oldest undrained Entry
+		};
+
+		struct EntryHeader {
+			boost::uint32_t protocol_key_length;
+			boost::uint32_t data_length;
+		};
+
+		static const boost::uint32_t wrap_marker = 0xFFFFFFFF;
+
+		std::string dead_letter_path;
+
+		boost::interprocess::file_mapping file;
+		boost::interprocess::mapped_region region;
+
+		Header *header;
+		char *buffer;
+		boost::uint64_t capacity;
+
+		boost::mutex mutex;
+		boost::condition_variable condition;
+};
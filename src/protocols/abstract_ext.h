@@ -21,6 +21,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <Poco/AutoPtr.h>
 #include <Poco/Data/Session.h>
 #include <Poco/Data/SessionPool.h>
+#include <Poco/Timestamp.h>
 #include <Poco/Util/IniFileConfiguration.h>
 
 #include <boost/log/core.hpp>
@@ -29,15 +30,253 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+class NativePool;
+class WriteJournal;
+
+
+class ResultStream
+// Streaming Result (6:), Protocols publish completed Rows of result while the Call is still running
+//	Client fetches published Parts with 5:ID, so it never waits for the whole Result
+{
+	public:
+		ResultStream(std::size_t stream_chunk_size) : chunk_size(stream_chunk_size) {}
+		virtual ~ResultStream() {}
+
+		// Moves result into Result Slot + clears it, waits while Client is behind
+		//	Throws Poco::TimeoutException once Client stops fetching, Call should give up
+		virtual void publish(std::string &result)=0;
+
+		bool ready(const std::string &result) const
+		{
+			return result.size() >= chunk_size;
+		}
+
+		std::size_t chunk_size;
+};
+
+
+class ResultCursor
+// Cursor (7: / 8:), Statement + DB Session of a Call stay open, Client fetches Rows a Page at a time
+{
+	public:
+		virtual ~ResultCursor() {}
+
+		// Next Page of Rows as [[...],[...]], throws Poco::Exception on Database Error
+		//	false = Page was rejected (i.e Output Sanitize Check), Cursor should be closed
+		virtual bool fetch(std::string &result)=0;
+
+		// All Rows were fetched
+		virtual bool done()=0;
+};
+
+
+struct SyncThread
+// Arma Server Thread (0: Sync Calls) -- DB Checkouts wait up to Sync Checkout Timeout instead of Checkout Timeout
+//	so a full Session Pool doesn't stall the Server Frame
+{
+	static void mark()
+	{
+		if (sync_thread.get() == nullptr)
+		{
+			sync_thread.reset(new bool(true));
+		}
+	}
+
+	static bool current()
+	{
+		return (sync_thread.get() != nullptr);
+	}
+
+	static boost::thread_specific_ptr<bool> sync_thread;
+};
+
+
+struct DBConnectionInfo
+// Database Connection, one per Database Config Section i.e 9:DATABASE:Database2
+{
+	DBConnectionInfo() : sync_checkout_timeout(0), statement_cache_memory(0), normalize_raw_sql(false), primary(nullptr), replica_max_lag(0), replica_check_interval(0), replica_available(false),
+		circuit_threshold(0), circuit_backoff(0), circuit_max_backoff(0), circuit_failures(0), circuit_open(false), journal_batch_size(0), journal_retries(0) {}
+
+	std::string name;
+	std::string db_type;
+	std::string connection_str;
+	int min_sessions;
+	int max_sessions;
+	int idle_time;
+	int checkout_timeout;
+	int sync_checkout_timeout;
+	bool thread_sessions;
+	int validation_interval;
+	int statement_cache_size;
+	int statement_cache_memory;  // KB per DB Session, 0 = No Limit
+	bool normalize_raw_sql;  // DB_RAW SQL Literals are replaced by Placeholders, so SQL of same Shape shares a Cached Statement
+
+	// Database Session Pool
+	boost::shared_ptr<Poco::Data::SessionPool> pool;
+
+	// Thread Sessions -- Each Thread keeps its own DB Session + Statement Cache checked out of pool
+	//   Declared after pool, so they are put back before pool is destroyed
+	struct ThreadSession {
+		Poco::Data::SessionPool *pool;
+		Poco::Data::SessionPool::SessionList::iterator itr;
+		Poco::Data::Session session;
+		Poco::Timestamp validated;
+		ThreadSession(Poco::Data::SessionPool *db_pool) : pool(db_pool), session(db_pool->extDB_get(itr)) {}
+		~ThreadSession() { pool->putBack(itr); }
+	};
+	boost::thread_specific_ptr<ThreadSession> thread_session;
+
+	// Pinned Session -- Journal Thread pins one DB Session for a Batch, so the Calls of a Batch run in one Transaction
+	//   getDBSession* return the Pinned Session on that Thread, putback leaves it checked out
+	struct PinnedSession {
+		Poco::Data::SessionPool *pool;
+		Poco::Data::SessionPool::SessionList::iterator itr;
+		Poco::Data::Session session;
+		PinnedSession(Poco::Data::SessionPool *db_pool, int checkout_timeout) : pool(db_pool), session(db_pool->extDB_get(itr, checkout_timeout)) {}
+		~PinnedSession() { pool->putBack(itr); }
+	};
+	boost::thread_specific_ptr<PinnedSession> pinned_session;
+
+	// Read Replica (MySQL) -- Read Only Calls use Replica, falls back to Primary while Replica is down or lagging
+	//   Replica Connection has primary set, Primary Connection has replica set
+	boost::shared_ptr<DBConnectionInfo> replica;
+	DBConnectionInfo *primary;
+	int replica_max_lag;  // Seconds, 0 = Lag not checked
+	int replica_check_interval;  // Seconds
+	std::atomic<bool> replica_available;
+
+	// Circuit Breaker -- Opens after Circuit Breaker Threshold Connection Failures in a row, 0 = Disabled
+	//   While open, Calls fail fast + Background Thread probes Database with Exponential Backoff
+	int circuit_threshold;
+	int circuit_backoff;  // Milliseconds
+	int circuit_max_backoff;  // Milliseconds
+	std::atomic<int> circuit_failures;
+	std::atomic<bool> circuit_open;
+	boost::mutex circuit_mutex;
+	boost::condition_variable circuit_condition;
+
+	// Write Journal -- One-Way Calls are appended to Journal, Journal Thread drains them to Database in Batches
+	boost::shared_ptr<WriteJournal> journal;
+	int journal_batch_size;
+	int journal_retries;  // Attempts before a failed Call is dead lettered
+
+	// Native Backend (NATIVE_SQLITE / NATIVE_MYSQL Builds) -- DB_RAW + DB_CUSTOM_V5 Calls skip Poco::Data, nullptr = Poco
+	boost::shared_ptr<NativePool> native;
+
+	// Shards (SQLite) -- Shard 0 = this Database Connection, DB_CUSTOM_V5 Calls pick a Shard by Shard Key
+	std::vector< boost::shared_ptr<DBConnectionInfo> > shards;  // Shard 1 .. N-1
+
+	std::size_t getShardCount() const
+	{
+		return shards.size() + 1;
+	}
+
+	DBConnectionInfo *getShardByIndex(std::size_t shard)
+	{
+		if (shard == 0)
+		{
+			return this;
+		}
+		return shards[shard - 1].get();
+	}
+
+	DBConnectionInfo *getShard(const std::string &shard_key)
+	// FNV-1a Hash of Shard Key, same Shard between restarts
+	{
+		if (shards.empty())
+		{
+			return this;
+		}
+		boost::uint32_t hash = 2166136261u;
+		for (std::string::const_iterator itr = shard_key.begin(); itr != shard_key.end(); ++itr)
+		{
+			hash ^= (unsigned char) *itr;
+			hash *= 16777619u;
+		}
+		return getShardByIndex(hash % getShardCount());
+	}
+
+	int getCheckoutTimeout() const
+	// Checkout Timeout of Calling Thread
+	{
+		return SyncThread::current() ? sync_checkout_timeout : checkout_timeout;
+	}
+
+	bool useNative() const
+	// Native Backend, skipped while a Session is pinned so the Call joins its Transaction
+	{
+		return (native && (pinned_session.get() == nullptr));
+	}
+
+	DBConnectionInfo *getReadDatabase()
+	// Returns Replica if available, else this Database Connection
+	//	Pinned Session = this Database Connection, Reads see the Writes of the Transaction
+	{
+		if (replica && replica_available.load() && (pinned_session.get() == nullptr))
+		{
+			return replica.get();
+		}
+		return this;
+	}
+};
+
+
+inline bool isReadOnlySQL(const std::string &sql)
+// Plain SELECT Statement, safe to run on a Read Replica
+//	No Locking Reads, SELECT ... INTO or Multiple Statements
+//	No Connection State (Last Insert ID, Row Counts, Named Locks, @ Variables), that would be read from another Connection
+{
+	static const char *connection_state[] = {
+		"@", "LAST_INSERT_ID", "LAST_INSERT_ROWID", "CHANGES(", "FOUND_ROWS", "ROW_COUNT", "CONNECTION_ID",
+		"GET_LOCK", "RELEASE_LOCK", "RELEASE_ALL_LOCKS", "IS_FREE_LOCK", "IS_USED_LOCK"
+	};
+	for (std::size_t i = 0; i < (sizeof(connection_state) / sizeof(connection_state[0])); ++i)
+	{
+		if (boost::algorithm::icontains(sql, connection_state[i]))
+		{
+			return false;
+		}
+	}
+
+	std::string::size_type pos = sql.find_first_not_of(" \t\r\n(");
+	if ((pos == std::string::npos) || (!boost::algorithm::istarts_with(sql.substr(pos), "SELECT")))
+	{
+		return false;
+	}
+	pos = sql.find(';');
+	if ((pos != std::string::npos) && (sql.find_first_not_of(" \t\r\n;", pos) != std::string::npos))
+	{
+		return false;
+	}
+	return !(boost::algorithm::icontains(sql, "FOR UPDATE") ||
+				boost::algorithm::icontains(sql, "LOCK IN SHARE MODE") ||
+				boost::algorithm::icontains(sql, " INTO "));
+}
 
 
 class AbstractExt
 {
 	public:
-		virtual Poco::Data::Session getDBSession_mutexlock()=0;
-		virtual Poco::Data::Session getDBSessionCustom_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr)=0;
-		virtual void putbackDBSession_mutexlock(Poco::Data::SessionPool::SessionList::iterator &itr)=0;
+		virtual Poco::Data::Session getDBSession_mutexlock(DBConnectionInfo *database)=0;
+		virtual Poco::Data::Session getDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)=0;
+		virtual void putbackDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)=0;
+		virtual void invalidateDBSession_mutexlock(DBConnectionInfo *database, Poco::Data::Session &session)=0;
+		virtual void invalidateDBSessionCustom_mutexlock(DBConnectionInfo *database, Poco::Data::SessionPool::SessionList::iterator &itr)=0;
+		virtual bool warmupDBSessions(DBConnectionInfo *database, const boost::function<bool (Poco::Data::Session &, Poco::Data::StatementLRUCache &)> &prepare, int timeout)=0;
 
 		virtual std::string getAPIKey()=0;
 		
@@ -46,10 +285,8 @@ class AbstractExt
 		virtual void freeUniqueID_mutexlock(const int &unique_id)=0;
 		virtual int getUniqueID_mutexlock()=0;
 		
-		virtual std::string getDBType()=0;
+		virtual std::string getDBType(DBConnectionInfo *database)=0;
 		virtual std::string getExtensionPath()=0;
 		
 		boost::log::sources::severity_logger_mt< boost::log::trivial::severity_level > logger;
-
-		boost::mutex mutex_poco_cached_preparedStatements;  // Using Same Lock for Wait / Results / Plugins
 };
\ No newline at end of file
@@ -21,6 +21,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 AbstractProtocol::AbstractProtocol()
 {
+	database = nullptr;
 }
 
 AbstractProtocol::~AbstractProtocol()
@@ -31,6 +32,22 @@ void AbstractProtocol::callProtocol(AbstractExt *extension, std::string input_st
 {
 }
 
+void AbstractProtocol::callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream)
+{
+	callProtocol(extension, input_str, result);
+}
+
+boost::shared_ptr<ResultCursor> AbstractProtocol::openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result)
+{
+	result = "[0,\"Error Cursor not supported\"]";
+	return boost::shared_ptr<ResultCursor>();
+}
+
+void AbstractProtocol::getBatchStats(std::string &result)
+{
+	result = "[0,\"Error Batching not supported\"]";
+}
+
 bool AbstractProtocol::init(AbstractExt *extension, const std::string init_str)
 {
 	// Use this function for any initialize, or if u need to read value from extdb-conf.ini i.e
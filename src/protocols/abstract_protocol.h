@@ -28,4 +28,15 @@ class AbstractProtocol
 
 		virtual bool init(AbstractExt *extension, const std::string init_str);
 		virtual void callProtocol(AbstractExt *extension, std::string input_str, std::string &result)=0;
+		// Streaming (6:), Protocols that support it publish Rows through stream as they are serialized
+		//	Default runs Call + whole Result is published once Call is done
+		virtual void callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream);
+		// Cursor (7:), Protocols that support it run the Call + keep its Statement open
+		//	Default = Cursors not supported, Error Message is in result + returns nullptr
+		virtual boost::shared_ptr<ResultCursor> openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result);
+		// Batch Stats (9:BATCH_STATS), Protocols that batch Calls return their Batching Metrics
+		//	Default = Batching not supported, Error Message is in result
+		virtual void getBatchStats(std::string &result);
+
+		DBConnectionInfo *database;  // Database Connection of Protocol, set before init
 };
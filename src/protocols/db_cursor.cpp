@@ -0,0 +1,141 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "db_cursor.h"
+
+#include <Poco/Data/Limit.h>
+#include <Poco/Data/MetaColumn.h>
+#include <Poco/Data/RecordSet.h>
+
+#include <Poco/Data/MySQL/MySQLException.h>
+
+
+DBCursor::DBCursor(AbstractExt *cursor_extension, DBConnectionInfo *cursor_database, std::size_t cursor_page_size, const ValueWriter &cursor_writer):
+	extension(cursor_extension),
+	database(cursor_database),
+	session(cursor_database->pool->extDB_get(session_itr)),
+	session_valid(true),
+	page_size(cursor_page_size),
+	first_page(true),
+	writer(cursor_writer)
+{
+}
+
+
+DBCursor::~DBCursor()
+{
+	// Statement is closed before its DB Session is put back
+	statement.reset();
+	if (!session_valid)
+	{
+		// Broken DB Session, putBack closes it instead of making it idle
+		extension->invalidateDBSessionCustom_mutexlock(database, session_itr);
+	}
+	database->pool->putBack(session_itr);
+}
+
+
+void DBCursor::open(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &sql_inputs)
+{
+	inputs = sql_inputs;
+	inputs.resize(sql.size());
+	try
+	{
+		for (std::vector<std::string>::size_type i = 0; i < sql.size(); ++i)
+		{
+			statement.reset(new Poco::Data::Statement(session));
+			*statement << sql[i];
+			for (std::vector<std::string>::size_type x = 0; x < inputs[i].size(); ++x)
+			{
+				*statement, Poco::Data::use(inputs[i][x]);
+			}
+			if (i == (sql.size() - 1))
+			{
+				*statement, Poco::Data::limit((Poco::UInt32) page_size);
+			}
+			statement->execute();
+		}
+	}
+	catch (Poco::Data::MySQL::ConnectionException&)
+	{
+		session_valid = false;
+		throw;
+	}
+}
+
+
+bool DBCursor::fetch(std::string &result)
+// First Page was extracted by open, each fetch after that extracts next Page
+{
+	if (!first_page)
+	{
+		try
+		{
+			statement->execute();
+		}
+		catch (Poco::Data::MySQL::ConnectionException&)
+		{
+			session_valid = false;
+			throw;
+		}
+	}
+	first_page = false;
+
+	bool status = true;
+	Poco::Data::RecordSet rs(*statement);
+
+	result = "[";
+	std::size_t cols = rs.columnCount();
+	if (cols >= 1)
+	{
+		bool more = rs.moveFirst();
+		while (more)
+		{
+			result += "[";
+			for (std::size_t col = 0; col < cols; ++col)
+			{
+				std::string temp_str = rs[col].convert<std::string>();
+				if (!writer(col, temp_str, (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING), result))
+				{
+					status = false;
+				}
+				if (col < (cols - 1))
+				{
+					result += ",";
+				}
+			}
+			more = rs.moveNext();
+			if (more)
+			{
+				result += "],";
+			}
+			else
+			{
+				result += "]";
+			}
+		}
+	}
+	result += "]";
+	return status;
+}
+
+
+bool DBCursor::done()
+{
+	return statement->done();
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "abstract_ext.h"
+
+#include <Poco/Data/SessionPool.h>
+#include <Poco/Data/Statement.h>
+
+#include <boost/function.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class DBCursor: public ResultCursor
+// Cursor on a Poco Statement, Statement + its own DB Session are held till Cursor is closed
+//	Rows are extracted a Page at a time (Poco::Data::limit), MySQL fetches Rows unbuffered + SQLite only steps as far as the Page
+//	DB Session is taken straight from Session Pool (not a Thread Session), it can't run other Calls while Cursor is open
+{
+	public:
+		// Writes one Value to result, false = Value rejected (i.e Output Sanitize Check)
+		typedef boost::function<bool (std::size_t col, std::string &value, bool string_type, std::string &result)> ValueWriter;
+
+		DBCursor(AbstractExt *extension, DBConnectionInfo *database, std::size_t page_size, const ValueWriter &writer);
+		~DBCursor();
+
+		// Runs every SQL Statement, last one is kept open as Cursor + its first Page is extracted
+		void open(const std::vector<std::string> &sql, const std::vector< std::vector<std::string> > &inputs);
+
+		bool fetch(std::string &result);
+		bool done();
+
+	private:
+		AbstractExt *extension;
+		DBConnectionInfo *database;
+
+		Poco::Data::SessionPool::SessionList::iterator session_itr;
+		Poco::Data::Session session;
+		bool session_valid;
+
+		std::unique_ptr<Poco::Data::Statement> statement;
+		std::vector< std::vector<std::string> > inputs;  // Bound by reference, kept till Cursor is closed
+
+		std::size_t page_size;
+		bool first_page;
+		ValueWriter writer;
+};
@@ -56,11 +56,11 @@ bool DB_CUSTOM_V3::init(AbstractExt *extension, const std::string init_str)
 	
 	bool status = false;
 	
-	if (extension->getDBType() == std::string("MySQL"))
+	if (extension->getDBType(database) == std::string("MySQL"))
 	{
 		status = true;
 	}
-	else if (extension->getDBType() == std::string("SQLite"))
+	else if (extension->getDBType(database) == std::string("SQLite"))
 	{
 		status =  true;
 	}
@@ -318,7 +318,7 @@ void DB_CUSTOM_V3::getBEGUID(std::string &input_str, std::string &result)
 
 void DB_CUSTOM_V3::callCustomProtocol(AbstractExt *extension, boost::unordered_map<std::string, Template_Calls>::const_iterator itr, std::vector< std::string > &tokens, bool &sanitize_value_check_ok, std::string &result)
 {
-	Poco::Data::Session db_session = extension->getDBSession_mutexlock();
+	Poco::Data::Session db_session = extension->getDBSession_mutexlock(database);
 	Poco::Data::Statement sql_current(db_session);
 
 	for(std::vector< std::list<Poco::DynamicAny> >::const_iterator it_sql_statements_vector = itr->second.sql_statements.begin(); it_sql_statements_vector != itr->second.sql_statements.end(); ++it_sql_statements_vector)
@@ -399,6 +399,9 @@ void DB_CUSTOM_V3::callCustomProtocol(AbstractExt *extension, boost::unordered_m
 				#endif
 				BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V3: Error ConnectionException: " + e.displayText();
 				BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V3: Error ConnectionException: SQL:" + sql_str;
+				result = "[0,\"Error Connection Exception\"]";
+				// Broken DB Session, close it instead of putting it back
+				extension->invalidateDBSession_mutexlock(database, db_session);
 			}
 			catch(Poco::Data::MySQL::StatementException& e)
 			{
@@ -604,7 +607,17 @@ void DB_CUSTOM_V3::callProtocol(AbstractExt *extension, std::string input_str, s
 			if (!(bad_chars_error))
 			{
 				bool sanitize_value_check_ok = true;
-				callCustomProtocol(extension, itr, inputs, sanitize_value_check_ok, result);
+				try
+				{
+					callCustomProtocol(extension, itr, inputs, sanitize_value_check_ok, result);
+				}
+				catch (Poco::Exception& e)
+				{
+					// DB Session Checkout, i.e SessionPoolExhaustedException after Checkout Timeout
+					BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V3: Error Exception: " + e.displayText();
+					BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V3: Error Exception: Input:" + input_str;
+					result = "[0,\"Error Exception\"]";
+				}
 				if (!sanitize_value_check_ok)
 				{
 					result = "[0,\"Error Values Input is not sanitized\"]";
@@ -30,6 +30,7 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <Poco/Exception.h>
 #include <Poco/String.h>
 #include <Poco/StringTokenizer.h>
+#include <Poco/Timestamp.h>
 #include <Poco/Util/AbstractConfiguration.h>
 #include <Poco/Util/IniFileConfiguration.h>
 
@@ -38,7 +39,10 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/erase.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/regex.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <algorithm>
@@ -48,7 +52,27 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 	#include <iostream>
 #endif
 
+#include "../backends/native_pool.h"
+#include "db_cursor.h"
 #include "../sanitize.h"
+#include "../sql_normalize.h"
+
+
+namespace
+{
+	struct DBSessionPutback
+	// Puts DB Session back when it goes out of scope, also when an Exception is thrown
+	{
+		DBSessionPutback(AbstractExt *session_extension, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr) :
+			extension(session_extension), database(session_database), itr(session_itr) {}
+		~DBSessionPutback() { extension->putbackDBSession_mutexlock(database, itr); }
+
+		AbstractExt *extension;
+		DBConnectionInfo *database;
+		Poco::Data::SessionPool::SessionList::iterator &itr;
+	};
+}
+
 
 bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 {
@@ -56,11 +80,11 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 	
 	bool status = false;
 	
-	if (extension->getDBType() == std::string("MySQL"))
+	if (extension->getDBType(database) == std::string("MySQL"))
 	{
 		status = true;
 	}
-	else if (extension->getDBType() == std::string("SQLite"))
+	else if (extension->getDBType(database) == std::string("SQLite"))
 	{
 		status =  true;
 	}
@@ -112,6 +136,8 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 			bool default_input_sanitize_value_check = template_ini->getBool("Default.Sanitize Input Value Check", true);
 			bool default_output_sanitize_value_check = template_ini->getBool("Default.Sanitize Output Value Check", true);
 			bool default_string_datatype_check = template_ini->getBool("Default.String Datatype Check", true);
+			bool default_read_only = template_ini->getBool("Default.Read Only", false);
+			int default_shard_key = template_ini->getInt("Default.Shard Key", 0);
 
 			std::string default_bad_chars = template_ini->getString("Default.Bad Chars");
 			int default_bad_chars_action = 0;
@@ -191,6 +217,21 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 
 					custom_protocol[call_name].input_sanitize_value_check = template_ini->getBool(call_name + ".Sanitize Value Check", default_input_sanitize_value_check);
 					custom_protocol[call_name].output_sanitize_value_check = template_ini->getBool(call_name + ".Sanitize Value Check", default_output_sanitize_value_check);
+					custom_protocol[call_name].read_only = template_ini->getBool(call_name + ".Read Only", default_read_only);
+					custom_protocol[call_name].broadcast = template_ini->getBool(call_name + ".Broadcast", false);
+					custom_protocol[call_name].transaction = template_ini->getBool(call_name + ".Transaction", false);
+					custom_protocol[call_name].batch_window = template_ini->getInt(call_name + ".Batch Window", 0);
+					custom_protocol[call_name].batch_max = template_ini->getInt(call_name + ".Batch Max", 50);
+					custom_protocol[call_name].batch_key_column = template_ini->getInt(call_name + ".Batch Key Column", 1);
+					custom_protocol[call_name].shard_key = template_ini->getInt(call_name + ".Shard Key", default_shard_key);
+					if ((custom_protocol[call_name].shard_key < 0) || (custom_protocol[call_name].shard_key > custom_protocol[call_name].number_of_inputs))
+					{
+						#ifdef TESTING
+							std::cout << "extDB: DB_CUSTOM_V5: " << call_name << ": Invalid Shard Key: " << custom_protocol[call_name].shard_key << std::endl;
+						#endif
+						BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: " << call_name << ": Invalid Shard Key: " << custom_protocol[call_name].shard_key;
+						custom_protocol[call_name].shard_key = 0;
+					}
 
 					while (true)
 					{
@@ -202,6 +243,22 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 
 							if (!(template_ini->has(call_name + ".SQL" + sql_line_num_str + "_1")))  // No More SQL Statements
 							{
+								// Return SQL, Rows of this SQL Line are returned instead of last SQL Line
+								custom_protocol[call_name].return_sql = template_ini->getInt(call_name + ".Return SQL", 0);
+								if ((custom_protocol[call_name].return_sql < 0) || (custom_protocol[call_name].return_sql >= sql_line_num))
+								{
+									status = false;
+									#ifdef TESTING
+										std::cout << "extDB: DB_CUSTOM_V5: Bad Return SQL: " << call_name << ":" << custom_protocol[call_name].return_sql << std::endl;
+									#endif
+									BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Bad Return SQL " << call_name << ":" << custom_protocol[call_name].return_sql;
+									custom_protocol[call_name].return_sql = 0;
+								}
+								else if ((custom_protocol[call_name].return_sql > 0) && (custom_protocol[call_name].return_sql < (sql_line_num - 1)))
+								{
+									custom_protocol[call_name].flow = true;
+								}
+
 								// Initialize Default Output Options
 
 								// Get Output Options
@@ -212,6 +269,18 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 									Value_Options outputs_options;
 									outputs_options.check = default_output_sanitize_value_check;
 
+									// Row Info, Affected Rows / Last Insert ID of returned SQL Line instead of its Rows
+									if (boost::iequals(tokens_output_options[i], std::string("AFFECTED_ROWS")) == 1)
+									{
+										custom_protocol[call_name].row_info_outputs.push_back(AFFECTED_ROWS);
+										continue;
+									}
+									else if (boost::iequals(tokens_output_options[i], std::string("INSERT_ID")) == 1)
+									{
+										custom_protocol[call_name].row_info_outputs.push_back(INSERT_ID);
+										continue;
+									}
+
 									Poco::StringTokenizer options_tokens(tokens_output_options[i], "-", Poco::StringTokenizer::TOK_TRIM);
 									for (int x = 0; x < (options_tokens.count()); ++x)
 									{
@@ -245,6 +314,64 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 									}
 									custom_protocol[call_name].sql_outputs_options.push_back(std::move(outputs_options));
 								}
+								if ((!custom_protocol[call_name].row_info_outputs.empty()) &&
+									((!custom_protocol[call_name].sql_outputs_options.empty()) || custom_protocol[call_name].broadcast))
+								{
+									// Row Info can't be mixed with Column Outputs, Broadcast would merge Row Info of every Shard
+									status = false;
+									#ifdef TESTING
+										std::cout << "extDB: DB_CUSTOM_V5: Bad Output Option: " << call_name << ": AFFECTED_ROWS / INSERT_ID" << std::endl;
+									#endif
+									BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Bad Output Option " << call_name << ": AFFECTED_ROWS / INSERT_ID";
+								}
+
+								if (custom_protocol[call_name].batch_window > 0)
+								{
+									// Batch -- One SQL Line with one "= ?" Integer Input (no STRING / BEGUID), "= ?" is replaced by "IN (?,..)"
+									Template_Call &template_call = custom_protocol[call_name];
+									bool batch_status = ((sql_line_num == 2) && (template_call.number_of_inputs == 1) &&
+										(template_call.sql_inputs_options[0].size() == 1) && (template_call.sql_inputs_options[0][0].sql_line == 0) &&
+										(!template_call.sql_inputs_options[0][0].string) && (!template_call.sql_inputs_options[0][0].beguid) &&
+										(template_call.batch_max > 1) && (template_call.batch_key_column > 0) &&
+										(!template_call.broadcast) && (template_call.shard_key == 0) && (!template_call.flow) && (!template_call.transaction) && template_call.row_info_outputs.empty());
+									if (batch_status)
+									{
+										const std::string &sql = template_call.sql_prepared_statements[0];
+										const std::string::size_type placeholder = SQL::findUnquoted(sql, '?');
+										std::string::size_type equals = std::string::npos;
+										if ((placeholder != std::string::npos) && (placeholder > 0))
+										{
+											equals = sql.find_last_not_of(" \t\r\n", placeholder - 1);
+										}
+										batch_status = ((equals != std::string::npos) && (equals > 0) && (sql[equals] == '=') &&
+											(std::string("<>!").find(sql[equals - 1]) == std::string::npos) &&
+											(SQL::findUnquoted(sql, '?', placeholder + 1) == std::string::npos));
+										if (batch_status)
+										{
+											template_call.batch_sql_prefix = sql.substr(0, equals);
+											template_call.batch_sql_suffix = sql.substr(placeholder + 1);
+
+											// Rows must belong to one Key each, Aggregates / DISTINCT / LIMIT / GROUP BY / HAVING would be applied across the whole Batch
+											static const boost::regex batch_bad_prefix("\\b(DISTINCT|(COUNT|SUM|MIN|MAX|AVG|GROUP_CONCAT)\\s*\\()", boost::regex::icase);
+											static const boost::regex batch_bad_suffix("\\b(LIMIT|GROUP\\s+BY|HAVING)\\b", boost::regex::icase);
+											batch_status = (boost::istarts_with(boost::trim_left_copy(template_call.batch_sql_prefix), "SELECT") &&
+												(!boost::regex_search(template_call.batch_sql_prefix, batch_bad_prefix)) &&
+												(!boost::regex_search(template_call.batch_sql_suffix, batch_bad_suffix)));
+										}
+										if (batch_status)
+										{
+											batch_queues[call_name].reset(new Batch_Queue());
+										}
+									}
+									if (!batch_status)
+									{
+										status = false;
+										#ifdef TESTING
+											std::cout << "extDB: DB_CUSTOM_V5: Bad Batch Options: " << call_name << std::endl;
+										#endif
+										BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Bad Batch Options " << call_name;
+									}
+								}
 								break;
 							}
 							
@@ -284,10 +411,29 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 							for (int x = 0; x < (tokens_input.count()); x++)
 							{
 								Poco::StringTokenizer tokens_input_options(tokens_input[x], "-");
+								inputs_options.sql_line = 0;
+								inputs_options.sql_column = 0;
 								
 								for (Poco::StringTokenizer::Iterator tokens_input_options_it = tokens_input_options.begin(); tokens_input_options_it != tokens_input_options.end(); ++tokens_input_options_it)
 								{
-									if (!(Poco::NumberParser::tryParse(*tokens_input_options_it, inputs_options.number)))
+									std::string::size_type found = tokens_input_options_it->find('.');
+									if (boost::istarts_with(*tokens_input_options_it, std::string("SQL")) && (found != std::string::npos) &&
+										Poco::NumberParser::tryParse(tokens_input_options_it->substr(3, (found - 3)), inputs_options.sql_line) &&
+										Poco::NumberParser::tryParse(tokens_input_options_it->substr(found + 1), inputs_options.sql_column))
+									{
+										// SQLm.c = Column c of first Row of SQL Line m
+										custom_protocol[call_name].flow = true;
+										if ((inputs_options.sql_line < 1) || (inputs_options.sql_line >= sql_line_num) || (inputs_options.sql_column < 1))
+										{
+											status = false;
+											#ifdef TESTING
+												std::cout << "extDB: DB_CUSTOM_V5: Bad Input Option: " << call_name << ":" << *tokens_input_options_it << std::endl;
+											#endif
+											BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Bad Input Option " << call_name << ":" << *tokens_input_options_it;
+											inputs_options.sql_line = 0;
+										}
+									}
+									else if (!(Poco::NumberParser::tryParse(*tokens_input_options_it, inputs_options.number)))
 									{
 										if (boost::iequals(*tokens_input_options_it, std::string("STRING")) == 1)
 										{
@@ -317,6 +463,24 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 								}
 								custom_protocol[call_name].sql_inputs_options[sql_line_num - 1].push_back(inputs_options);
 							}
+
+							// SQLn_IF_EMPTY = m, SQL Line n only runs if SQL Line m ran + returned / affected 0 Rows
+							//	MySQL counts changed Rows for UPDATE (no CLIENT_FOUND_ROWS), use a SELECT as SQL Line m to check if a Row exists
+							int sql_if_empty = template_ini->getInt(call_name + ".SQL" + sql_line_num_str + "_IF_EMPTY", 0);
+							if ((sql_if_empty < 0) || (sql_if_empty >= sql_line_num))
+							{
+								status = false;
+								#ifdef TESTING
+									std::cout << "extDB: DB_CUSTOM_V5: Bad SQL" << sql_line_num_str << "_IF_EMPTY: " << call_name << ":" << sql_if_empty << std::endl;
+								#endif
+								BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Bad SQL" << sql_line_num_str << "_IF_EMPTY " << call_name << ":" << sql_if_empty;
+								sql_if_empty = 0;
+							}
+							else if (sql_if_empty > 0)
+							{
+								custom_protocol[call_name].flow = true;
+							}
+							custom_protocol[call_name].sql_if_empty.push_back(sql_if_empty);
 						}
 						else
 						{
@@ -355,6 +519,72 @@ bool DB_CUSTOM_V5::init(AbstractExt *extension, const std::string init_str)
 		#endif
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: No Template File Found: " << db_template_file;
 	}
+
+	// Statement Cache Key, SQL Statements of a Call
+	for (std::unordered_map<std::string, Template_Call>::iterator itr = custom_protocol.begin(); itr != custom_protocol.end(); ++itr)
+	{
+		for (std::vector< std::string >::const_iterator it_sql_prepared_statements_vector = itr->second.sql_prepared_statements.begin(); it_sql_prepared_statements_vector != itr->second.sql_prepared_statements.end(); ++it_sql_prepared_statements_vector)
+		{
+			itr->second.sql_cache_key += *it_sql_prepared_statements_vector + "\n";
+		}
+	}
+
+	// Warmup, Prepare all SQL Statements on Database Sessions before first Call
+	if (status && template_ini->getBool("Default.Warmup", false))
+	{
+		Poco::Timestamp warmup_start;
+		status = extension->warmupDBSessions(database, boost::bind(&DB_CUSTOM_V5::warmupStatements, this, extension, _1, _2), template_ini->getInt("Default.Warmup Timeout", 10000));
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Warmup: " << (warmup_start.elapsed() / 1000) << "ms" << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::info) << "extDB: DB_CUSTOM_V5: Warmup: " << (warmup_start.elapsed() / 1000) << "ms";
+		if (!status)
+		{
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Warmup Failed: " << db_template_file;
+		}
+	}
+	return status;
+}
+
+
+bool DB_CUSTOM_V5::warmupStatements(AbstractExt *extension, Poco::Data::Session &session, Poco::Data::StatementLRUCache &statement_cache_lru)
+// Prepares SQL Statements of every Call into Statement Cache of DB Session
+{
+	bool status = true;
+	for (std::unordered_map<std::string, Template_Call>::const_iterator itr = custom_protocol.begin(); itr != custom_protocol.end(); ++itr)
+	{
+		if (itr->second.sql_prepared_statements.empty() || statement_cache_lru.contains(itr->second.sql_cache_key))
+		{
+			continue;
+		}
+
+		Poco::Data::SessionPool::StatementCache statement_cache;
+		Poco::Timestamp prepare_start;
+		for (std::vector< std::string >::const_iterator it_sql_prepared_statements_vector = itr->second.sql_prepared_statements.begin(); it_sql_prepared_statements_vector != itr->second.sql_prepared_statements.end(); ++it_sql_prepared_statements_vector)
+		{
+			try
+			{
+				Poco::Data::Statement sql_statement(session);
+				sql_statement << *it_sql_prepared_statements_vector;
+				sql_statement.extDB_prepare();
+				statement_cache.push_back(std::move(sql_statement));
+			}
+			catch (Poco::Exception& e)
+			{
+				status = false;
+				#ifdef TESTING
+					std::cout << "extDB: DB_CUSTOM_V5: Warmup: Error Preparing " << itr->first << ": " << e.displayText() << std::endl;
+				#endif
+				BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Warmup: Error Preparing " << itr->first << ": " << e.displayText();
+				BOOST_LOG_SEV(extension->logger, boost::log::trivial::fatal) << "extDB: DB_CUSTOM_V5: Warmup: Error Preparing " << itr->first << ": SQL: " << *it_sql_prepared_statements_vector;
+				break;
+			}
+		}
+		if (statement_cache.size() == itr->second.sql_prepared_statements.size())
+		{
+			statement_cache_lru.insert(itr->second.sql_cache_key, statement_cache, prepare_start.elapsed());
+		}
+	}
 	return status;
 }
 
@@ -407,7 +637,92 @@ void DB_CUSTOM_V5::getBEGUID(std::string &input_str, std::string &result)
 }
 
 
-void DB_CUSTOM_V5::getResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, Poco::Data::Statement &sql_statement, std::string &result)
+void DB_CUSTOM_V5::getValue(const Template_Call &template_call, std::size_t col, std::string &temp_str, bool string_type, std::string &result, bool &sanitize_value_check)
+// Output of one Column Value, used by Poco RecordSet + Native Backend
+{
+	// NO OUTPUT OPTIONS 
+	if (col >= template_call.sql_outputs_options.size())
+	{
+		// DEFAULT BEHAVIOUR
+		if ((template_call.string_datatype_check) && (string_type))
+		{
+			if (temp_str.empty())
+			{
+				result += ("\"\"");
+			}
+			else
+			{
+				result += "\"" + temp_str + "\"";
+			}
+		}
+		else if (temp_str.empty())
+		{
+			result += ("\"\"");
+		}
+		else
+		{
+			result += temp_str;
+		}
+	}
+	else
+	{
+	// OUTPUT OPTIONS
+
+		// BEGUID
+		if (template_call.sql_outputs_options[col].beguid)
+		{
+			getBEGUID(temp_str, temp_str);
+		}
+
+		// STRING
+		if (template_call.sql_outputs_options[col].string)
+		{
+			if (temp_str.empty())
+			{
+				temp_str = ("\"\"");
+			}
+			else
+			{
+				boost::erase_all(temp_str, "\"");
+				temp_str = "\"" + temp_str + "\"";
+			}
+		}
+
+		// STRING DATATYPE CHECK
+		else if ((template_call.sql_outputs_options[col].string_datatype_check) && (string_type))
+		{
+			if (temp_str.empty())
+			{
+				temp_str = ("\"\"");
+			}
+			else
+			{
+				boost::erase_all(temp_str, "\"");
+				temp_str = "\"" + temp_str + "\"";
+			}
+		}
+		else
+		{
+			if (temp_str.empty())
+			{
+				temp_str = ("\"\"");
+			}
+		}						
+
+		// SANITIZE CHECK
+		if (template_call.sql_outputs_options[col].check)
+		{
+			if (!Sqf::check(temp_str))
+			{
+				sanitize_value_check = false;
+			}
+		}
+		result += temp_str;
+	}
+}
+
+
+void DB_CUSTOM_V5::getResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, Poco::Data::Statement &sql_statement, std::string &result, ResultStream *stream)
 {
 	bool sanitize_value_check = true;
 	Poco::Data::RecordSet rs(sql_statement);
@@ -420,106 +735,26 @@ void DB_CUSTOM_V5::getResult(std::unordered_map<std::string, Template_Call>::con
 		while (more)
 		{
 			result += "[";
-			std::size_t sql_output_options_size = itr->second.sql_outputs_options.size();
-
 			for (std::size_t col = 0; col < cols; ++col)
 			{
 				std::string temp_str = rs[col].convert<std::string>();
-				
-				// NO OUTPUT OPTIONS 
-				if (col >= sql_output_options_size)
-				{
-					// DEFAULT BEHAVIOUR
-					if ((itr->second.string_datatype_check) && (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING))
-					{
-						if (temp_str.empty())
-						{
-							result += ("\"\"");
-						}
-						else
-						{
-							result += "\"" + temp_str + "\"";
-						}
-					}
-					else if (temp_str.empty())
-					{
-						result += ("\"\"");
-					}
-					else
-					{
-						result += temp_str;
-					}
-				}
-				else
-				{
-				// OUTPUT OPTIONS
-
-					// BEGUID
-					if (itr-> second.sql_outputs_options[col].beguid)
-					{
-						getBEGUID(temp_str, temp_str);
-					}
-
-					// STRING
-					if (itr-> second.sql_outputs_options[col].string)
-					{
-						if (temp_str.empty())
-						{
-							temp_str = ("\"\"");
-						}
-						else
-						{
-							boost::erase_all(temp_str, "\"");
-							temp_str = "\"" + temp_str + "\"";
-						}
-					}
-
-					// STRING DATATYPE CHECK
-					else if ((itr-> second.sql_outputs_options[col].string_datatype_check) && (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING))
-					{
-						if (temp_str.empty())
-						{
-							temp_str = ("\"\"");
-						}
-						else
-						{
-							boost::erase_all(temp_str, "\"");
-							temp_str = "\"" + temp_str + "\"";
-						}
-					}
-					else
-					{
-						if (temp_str.empty())
-						{
-							temp_str = ("\"\"");
-						}
-					}						
-
-					// SANITIZE CHECK
-					if (itr-> second.sql_outputs_options[col].check)
-					{
-						if (!Sqf::check(temp_str))
-						{
-							sanitize_value_check = false;
-						}
-					}
-					result += temp_str;
-				}
-
+				getValue(itr->second, col, temp_str, (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING), result, sanitize_value_check);
 				if (col < (cols - 1))
 				{
 					result += ",";
 				}
 			}
 
-			more = rs.moveNext();
-			if (more)
+			result += "]";
+			// Published on a Row boundary, so an Error Trailer can close the Rows
+			if ((stream != nullptr) && stream->ready(result))
 			{
-				result += "],";
+				stream->publish(result);
 			}
-			else
+			more = rs.moveNext();
+			if (more)
 			{
-				result += "]";
+				result += ",";
 			}
 		}
 	}
@@ -532,13 +767,91 @@ void DB_CUSTOM_V5::getResult(std::unordered_map<std::string, Template_Call>::con
 }
 
 
-void DB_CUSTOM_V5::executeSQL(AbstractExt *extension, Poco::Data::Statement &sql_statement, std::string &result, bool &status)
+void DB_CUSTOM_V5::getRowInfoResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, unsigned long long affected_rows, unsigned long long insert_id, std::string &result)
+// Row Info Outputs as [1,[..]] in OUTPUT Order
+{
+	result = "[1,[";
+	for (std::vector<Row_Info>::const_iterator it = itr->second.row_info_outputs.begin(); it != itr->second.row_info_outputs.end(); ++it)
+	{
+		if (it != itr->second.row_info_outputs.begin())
+		{
+			result += ",";
+		}
+		result += Poco::NumberFormatter::format((Poco::UInt64) ((*it == AFFECTED_ROWS) ? affected_rows : insert_id));
+	}
+	result += "]]";
+}
+
+
+unsigned long long DB_CUSTOM_V5::lastInsertID(Poco::Data::Session &session, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr)
+// Last Insert ID of DB Session, runs on the same Connection as the Call so it is never another Session's ID
+//	Cached in DB Session Statement Cache same as Call SQL Statements, Exceptions are left to caller
 {
+	const std::string cache_key = "extDB_LAST_INSERT_ID";
+	Poco::Data::SessionPool::StatementCache *statement_cache = session_itr->second.find(cache_key);
+	if (statement_cache == nullptr)
+	{
+		Poco::Data::SessionPool::StatementCache new_statement_cache;
+		Poco::Timestamp prepare_start;
+		Poco::Data::Statement sql_statement(session);
+		if (session_database->db_type == "SQLite")
+		{
+			sql_statement << "SELECT last_insert_rowid()";
+		}
+		else
+		{
+			sql_statement << "SELECT LAST_INSERT_ID()";
+		}
+		sql_statement.extDB_prepare();
+		new_statement_cache.push_back(std::move(sql_statement));
+		statement_cache = &(session_itr->second.insert(cache_key, new_statement_cache, prepare_start.elapsed()));
+	}
+
 	try
 	{
-		sql_statement.execute();
+		(*statement_cache)[0].execute();
+		Poco::Data::RecordSet rs((*statement_cache)[0]);
+		unsigned long long insert_id = 0;
+		if ((rs.columnCount() > 0) && rs.moveFirst())
+		{
+			insert_id = rs[0].convert<Poco::UInt64>();
+		}
+		return insert_id;
+	}
+	catch (...)
+	{
+		session_itr->second.erase(cache_key);
+		throw;
 	}
+}
 
+
+bool DB_CUSTOM_V5::nativeCustomProtocol(AbstractExt *extension, DBConnectionInfo *session_database, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &result, ResultStream *stream, bool &status)
+// Runs Call on Native Backend, Rows are written straight into result
+//	false = SQL not supported natively, use Poco
+{
+	try
+	{
+		bool sanitize_value_check = true;
+		const Template_Call &template_call = itr->second;
+		NativePool::RowInfo row_info;
+		bool native = session_database->native->execute(template_call.sql_prepared_statements, all_processed_inputs,
+			[this, &template_call, &sanitize_value_check](std::size_t col, const char *value, std::size_t value_size, bool string_type, std::string &value_result)
+			{
+				std::string temp_str(value, value_size);
+				getValue(template_call, col, temp_str, string_type, value_result, sanitize_value_check);
+			},
+			result, (template_call.row_info_outputs.empty() ? stream : nullptr), (template_call.row_info_outputs.empty() ? nullptr : &row_info));
+		if (native && (!sanitize_value_check))
+		{
+			result = "[0,\"Error Values Input is not sanitized\"]";
+		}
+		else if (native && (!template_call.row_info_outputs.empty()))
+		{
+			getRowInfoResult(itr, row_info.affected_rows, row_info.insert_id, result);
+		}
+		return native;
+	}
 	catch (Poco::Data::SQLite::DBLockedException& e)
 	{
 		status = false;
@@ -555,6 +868,7 @@ void DB_CUSTOM_V5::executeSQL(AbstractExt *extension, Poco::Data::Statement &sql
 			std::cout << "extDB: DB_CUSTOM_V5: Error ConnectionException: " + e.displayText() << std::endl;
 		#endif
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error ConnectionException: " + e.displayText();
+		result = "[0,\"Error Connection Exception\"]";
 	}
 	catch(Poco::Data::MySQL::StatementException& e)
 	{
@@ -583,94 +897,551 @@ void DB_CUSTOM_V5::executeSQL(AbstractExt *extension, Poco::Data::Statement &sql
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Exception: " + e.displayText();
 		result = "[0,\"Error Exception\"]";
 	}
+	return true;
 }
 
 
-void DB_CUSTOM_V5::callCustomProtocol(AbstractExt *extension, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result)
+std::size_t DB_CUSTOM_V5::executeSQL(AbstractExt *extension, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr, Poco::Data::Statement &sql_statement, std::string &result, bool &status)
+// Returns Rows returned / affected
 {
-	boost::lock_guard<boost::mutex> lock(extension->mutex_poco_cached_preparedStatements);
-
-	bool status = true;
-
-	Poco::Data::SessionPool::SessionList::iterator session_itr;
-	Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(session_itr);
-
-	std::unordered_map <std::string, Poco::Data::SessionPool::StatementCache>::iterator statement_cache_itr = session_itr->second.find(call_name);
-	if (statement_cache_itr == session_itr->second.end())
+	std::size_t rows = 0;
+	try
 	{
-		// NO CACHE
-
-		int i = -1;
-		for (std::vector< std::string >::const_iterator it_sql_prepared_statements_vector = itr->second.sql_prepared_statements.begin(); it_sql_prepared_statements_vector != itr->second.sql_prepared_statements.end(); ++it_sql_prepared_statements_vector)
-		{
-			i++;
-
-			Poco::Data::Statement sql_statement(session);
-
-			if (itr->second.number_of_inputs == 0)
-			{
-				sql_statement << *it_sql_prepared_statements_vector;
-			}
-			else
-			{
-				sql_statement << *it_sql_prepared_statements_vector;
-				for (int x = 0; x < all_processed_inputs[i].size(); x++)
-				{
-					sql_statement, Poco::Data::use(all_processed_inputs[i][x]);
-				}
-			}
-
-			executeSQL(extension, sql_statement, result, status);
-
-			if (status)
-			{
-				if ( it_sql_prepared_statements_vector+1 == itr->second.sql_prepared_statements.end() )
-				{
-					getResult(itr, sql_statement, result);
-				}
-				session_itr->second[call_name].push_back(std::move(sql_statement));
-			}
-			else
-			{
-				session_itr->second.erase(call_name);
-				break;
-			}
-		}
+		rows = sql_statement.execute();
 	}
-	else
+
+	catch (Poco::Data::SQLite::DBLockedException& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Error DBLockedException: " + e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error DBLockedException: " + e.displayText();
+		result = "[0,\"Error DBLocked Exception\"]";
+	}
+	catch (Poco::Data::MySQL::ConnectionException& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Error ConnectionException: " + e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error ConnectionException: " + e.displayText();
+		result = "[0,\"Error Connection Exception\"]";
+		// Broken DB Session, close it instead of putting it back
+		extension->invalidateDBSessionCustom_mutexlock(session_database, session_itr);
+	}
+	catch(Poco::Data::MySQL::StatementException& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Error StatementException: " + e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error StatementException: " + e.displayText();
+		result = "[0,\"Error Statement Exception\"]";
+	}
+	catch (Poco::Data::DataException& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Error DataException: " + e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error DataException: " + e.displayText();
+		result = "[0,\"Error Data Exception\"]";
+	}
+	catch (Poco::Exception& e)
+	{
+		status = false;
+		#ifdef TESTING
+			std::cout << "extDB: DB_CUSTOM_V5: Error Exception: " + e.displayText() << std::endl;
+		#endif
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Exception: " + e.displayText();
+		result = "[0,\"Error Exception\"]";
+	}
+	return rows;
+}
+
+
+void DB_CUSTOM_V5::transactionSQL(AbstractExt *extension, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr, Poco::Data::Session &session, const std::string &sql_str, std::string &result, bool &status)
+// BEGIN / COMMIT / ROLLBACK (Savepoints when nested), same Error Handling as SQL Lines
+{
+	Poco::Data::Statement sql_statement(session);
+	sql_statement << sql_str;
+	executeSQL(extension, session_database, session_itr, sql_statement, result, status);
+}
+
+
+void DB_CUSTOM_V5::broadcastCustomProtocol(AbstractExt *extension, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result)
+// Runs Call on every Shard in turn, Rows of all Shards are merged into one Result
+//	First Shard Error is returned
+{
+	std::string merged_rows;
+	std::string shard_result;
+	for (std::size_t shard = 0; shard < database->getShardCount(); ++shard)
+	{
+		shard_result.clear();
+		callCustomProtocol(extension, database->getShardByIndex(shard), call_name, itr, all_processed_inputs, input_str, shard_result, nullptr);
+		if ((!boost::algorithm::starts_with(shard_result, "[1,[")) || (shard_result.size() < 6))
+		{
+			result = shard_result;
+			return;
+		}
+		// [1,[ROWS]]
+		if (shard_result.size() > 6)
+		{
+			if (!merged_rows.empty())
+			{
+				merged_rows += ",";
+			}
+			merged_rows.append(shard_result, 4, shard_result.size() - 6);
+		}
+	}
+	result = "[1,[" + merged_rows + "]]";
+}
+
+
+void DB_CUSTOM_V5::callCustomProtocol(AbstractExt *extension, DBConnectionInfo *call_database, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result, ResultStream *stream)
+{
+	bool status = true;
+
+	// Read Only Calls use Read Replica if available, DB Session is put back to same Database
+	DBConnectionInfo *session_database = call_database;
+	if (itr->second.read_only)
+	{
+		session_database = call_database->getReadDatabase();
+	}
+
+	if (session_database->useNative() && (!itr->second.flow) && (!itr->second.transaction) && nativeCustomProtocol(extension, session_database, itr, all_processed_inputs, result, stream, status))
+	{
+		logCustomProtocol(extension, input_str, result, status);
+		return;
+	}
+
+	Poco::Data::SessionPool::SessionList::iterator session_itr;
+	Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(session_database, session_itr);
+
+	Poco::Data::SessionPool::StatementCache *statement_cache = session_itr->second.find(itr->second.sql_cache_key);
+	if (statement_cache == nullptr)
+	{
+		// NO CACHE, Prepare SQL Statements + Add to Cache
+		Poco::Data::SessionPool::StatementCache new_statement_cache;
+		Poco::Timestamp prepare_start;
+		try
+		{
+			for (std::vector< std::string >::const_iterator it_sql_prepared_statements_vector = itr->second.sql_prepared_statements.begin(); it_sql_prepared_statements_vector != itr->second.sql_prepared_statements.end(); ++it_sql_prepared_statements_vector)
+			{
+				Poco::Data::Statement sql_statement(session);
+				sql_statement << *it_sql_prepared_statements_vector;
+				sql_statement.extDB_prepare();
+				new_statement_cache.push_back(std::move(sql_statement));
+			}
+			statement_cache = &(session_itr->second.insert(itr->second.sql_cache_key, new_statement_cache, prepare_start.elapsed()));
+		}
+		catch (Poco::Exception& e)
+		{
+			status = false;
+			#ifdef TESTING
+				std::cout << "extDB: DB_CUSTOM_V5: Error Preparing Statement: " + e.displayText() << std::endl;
+			#endif
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Preparing Statement: " + e.displayText();
+			result = "[0,\"Error Exception\"]";
+		}
+	}
+
+	// Transaction -- DB Session already in a Transaction (Journal Batch) uses a Savepoint instead
+	const bool nested = session.isTransaction();
+	bool transaction = false;
+	if (status && itr->second.transaction)
+	{
+		transactionSQL(extension, session_database, session_itr, session, (nested ? "SAVEPOINT extDB_Call" : "BEGIN"), result, status);
+		transaction = status;
+	}
+
+	if (status)
 	{
 		// CACHE
-		for (std::vector<int>::size_type i = 0; i != statement_cache_itr->second.size(); i++)
+		// Flow -- Rows returned / affected by each SQL Statement (-1 = skipped) + first Row for SQLm.c Inputs
+		const std::vector<int>::size_type return_sql = (itr->second.return_sql > 0) ? (itr->second.return_sql - 1) : (statement_cache->size() - 1);
+		std::vector<long> sql_rows(statement_cache->size(), -1);
+		std::vector< std::vector<std::string> > sql_first_rows(statement_cache->size());
+
+		for (std::vector<int>::size_type i = 0; i != statement_cache->size(); i++)
 		{
-			statement_cache_itr->second[i].bindClear();
+			if (itr->second.flow)
+			{
+				if ((itr->second.sql_if_empty[i] > 0) && (sql_rows[itr->second.sql_if_empty[i] - 1] != 0))
+				{
+					continue;
+				}
+				for (std::vector<std::string>::size_type x = 0; x < all_processed_inputs[i].size(); x++)
+				{
+					const Value_Options &input_options = itr->second.sql_inputs_options[i][x];
+					if (input_options.sql_line > 0)
+					{
+						const std::vector<std::string> &first_row = sql_first_rows[input_options.sql_line - 1];
+						all_processed_inputs[i][x] = (((std::size_t) input_options.sql_column) <= first_row.size()) ? first_row[input_options.sql_column - 1] : std::string();
+					}
+				}
+			}
+
+			(*statement_cache)[i].bindClear();
 			for (int x = 0; x < all_processed_inputs[i].size(); x++)
 			{
-				statement_cache_itr->second[i], Poco::Data::use(all_processed_inputs[i][x]);
+				(*statement_cache)[i], Poco::Data::use(all_processed_inputs[i][x]);
 			}
-			statement_cache_itr->second[i].bindFixup();
+			(*statement_cache)[i].bindFixup();
 
-			executeSQL(extension, statement_cache_itr->second[i], result, status);
+			const std::size_t rows = executeSQL(extension, session_database, session_itr, (*statement_cache)[i], result, status);
 
 			if (status)
 			{
-				if (i == (statement_cache_itr->second.size() - 1))
+				sql_rows[i] = (long) rows;
+				if (itr->second.flow)
 				{
-					getResult(itr, statement_cache_itr->second[i], result);
+					Poco::Data::RecordSet rs((*statement_cache)[i]);
+					if ((rs.columnCount() > 0) && rs.moveFirst())
+					{
+						for (std::size_t col = 0; col < rs.columnCount(); ++col)
+						{
+							sql_first_rows[i].push_back(rs[col].convert<std::string>());
+						}
+					}
+				}
+				if (i == return_sql)
+				{
+					if (itr->second.row_info_outputs.empty())
+					{
+						getResult(itr, (*statement_cache)[i], result, stream);
+					}
+					else
+					{
+						// Before later SQL Lines can change Last Insert ID
+						try
+						{
+							getRowInfoResult(itr, rows, lastInsertID(session, session_database, session_itr), result);
+						}
+						catch (Poco::Data::MySQL::ConnectionException& e)
+						{
+							status = false;
+							extension->invalidateDBSessionCustom_mutexlock(session_database, session_itr);
+							BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Last Insert ID: ConnectionException: " + e.displayText();
+							result = "[0,\"Error Connection Exception\"]";
+						}
+						catch (Poco::Exception& e)
+						{
+							status = false;
+							BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Last Insert ID: " + e.displayText();
+							result = "[0,\"Error Exception\"]";
+						}
+						if (!status)
+						{
+							session_itr->second.erase(itr->second.sql_cache_key);
+							break;
+						}
+					}
 				}
 			}
 			else
 			{
 				// Exception Encountered, BREAK + Remove Cache
-				
-				session_itr->second.erase(call_name);
+				session_itr->second.erase(itr->second.sql_cache_key);
 				break;
 			}
-			
 		}
+
+		if (status && (sql_rows[return_sql] < 0))
+		{
+			// Returned SQL Statement was skipped
+			result = "[1,[]]";
+		}
+	}
+
+	if (transaction)
+	{
+		if (status)
+		{
+			transactionSQL(extension, session_database, session_itr, session, (nested ? "RELEASE SAVEPOINT extDB_Call" : "COMMIT"), result, status);
+		}
+		if ((!status) && (!session_itr->invalidated))
+		{
+			std::string rollback_result;
+			bool rollback_status = true;
+			transactionSQL(extension, session_database, session_itr, session, (nested ? "ROLLBACK TO SAVEPOINT extDB_Call" : "ROLLBACK"), rollback_result, rollback_status);
+		}
+	}
+
+	extension->putbackDBSession_mutexlock(session_database, session_itr);
+	logCustomProtocol(extension, input_str, result, status);
+}
+
+
+void DB_CUSTOM_V5::batchCallProtocol(AbstractExt *extension, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::string &input_str, const std::string &key, std::string &result)
+// Adds Call to Batch of its Template Call, first Call of a Batch waits up to Batch Window ms (or till Batch Max Calls) + runs it
+//	Other Calls wait for the Result of their Key
+//	Keys are Integers, normalized so Rows match them the same way the Database compares them (i.e 007 = 7)
+//	Sync Calls would block the Arma Server Thread for Batch Window, they are rejected
+{
+	if (SyncThread::current())
+	{
+		result = "[0,\"Error Batch Calls must be ASYNC\"]";
+		logCustomProtocol(extension, input_str, result, false);
+		return;
+	}
+
+	Poco::Int64 key_value;
+	if (!Poco::NumberParser::tryParse64(key, key_value))
+	{
+		result = "[0,\"Error Batch Key is not an Integer\"]";
+		logCustomProtocol(extension, input_str, result, false);
+		return;
+	}
+
+	Batch_Queue &queue = *(batch_queues.find(itr->first)->second);
+	const std::size_t batch_max = (std::size_t) itr->second.batch_max;
+
+	boost::unique_lock<boost::mutex> lock(queue.mutex);
+	bool leader = false;
+	if ((!queue.collecting) || (queue.collecting->keys.size() >= batch_max))
+	{
+		queue.collecting.reset(new Batch());
+		leader = true;
+	}
+	boost::shared_ptr<Batch> batch = queue.collecting;
+	const std::size_t call_index = batch->keys.size();
+	batch->keys.push_back(Poco::NumberFormatter::format(key_value));
+
+	if (leader)
+	{
+		queue.condition.wait_for(lock, boost::chrono::milliseconds(itr->second.batch_window), [&batch, batch_max]{ return batch->keys.size() >= batch_max; });
+		if (queue.collecting == batch)
+		{
+			queue.collecting.reset();
+		}
+		lock.unlock();
+
+		Poco::Timestamp query_start;
+		try
+		{
+			batchCustomProtocol(extension, itr, batch->keys, batch->results);
+		}
+		catch (Poco::Exception& e)
+		{
+			// Other Calls of Batch are waiting on it, so every Call gets the Error
+			#ifdef TESTING
+				std::cout << "extDB: DB_CUSTOM_V5: Error Batch: " + e.displayText() << std::endl;
+			#endif
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Batch: " + e.displayText();
+			batch->results.assign(batch->keys.size(), "[0,\"Error Exception\"]");
+		}
+		catch (...)
+		{
+			// Batch is always marked done, else its other Calls would wait forever
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Batch: Unknown Exception";
+			batch->results.assign(batch->keys.size(), "[0,\"Error Exception\"]");
+		}
+		const Poco::Int64 query_time = query_start.elapsed();
+
+		lock.lock();
+		batch->done = true;
+		++queue.batches;
+		queue.batched_calls += batch->keys.size();
+		queue.max_batch_size = std::max(queue.max_batch_size, (Poco::UInt64) batch->keys.size());
+		queue.query_time += query_time;
+		queue.condition.notify_all();
+	}
+	else
+	{
+		if (batch->keys.size() >= batch_max)
+		{
+			queue.condition.notify_all();
+		}
+		queue.condition.wait(lock, [&batch]{ return batch->done; });
+	}
+	result = batch->results[call_index];
+	lock.unlock();
+
+	logCustomProtocol(extension, input_str, result, boost::algorithm::starts_with(result, "[1,"));
+}
+
+
+void DB_CUSTOM_V5::batchCustomProtocol(AbstractExt *extension, std::unordered_map<std::string, Template_Call>::const_iterator itr, const std::vector< std::string > &keys, std::vector< std::string > &results)
+// Runs Batch as one WHERE key IN (...) Query on Poco, Rows are matched to Calls by Batch Key Column (as Integer)
+//	Duplicate Keys are bound once, IN List is padded to a Power of 2 (max Batch Max) so few Statements get cached
+{
+	bool status = true;
+	std::string result;
+
+	std::vector< std::string > unique_keys;
+	std::unordered_map< std::string, std::size_t > key_index;
+	for (std::vector< std::string >::const_iterator it = keys.begin(); it != keys.end(); ++it)
+	{
+		if (key_index.insert(std::make_pair(*it, unique_keys.size())).second)
+		{
+			unique_keys.push_back(*it);
+		}
+	}
+	std::size_t placeholders = 1;
+	while (placeholders < unique_keys.size())
+	{
+		placeholders *= 2;
+	}
+	placeholders = std::min(placeholders, std::max(unique_keys.size(), (std::size_t) itr->second.batch_max));
+
+	std::string sql = itr->second.batch_sql_prefix + " IN (?";
+	for (std::size_t i = 1; i < placeholders; ++i)
+	{
+		sql += ",?";
+	}
+	sql += ")" + itr->second.batch_sql_suffix;
+
+	std::vector< std::string > key_rows(unique_keys.size());
+	std::vector< bool > key_sanitize_value_check(unique_keys.size(), true);
+
+	DBConnectionInfo *session_database = database;
+	if (itr->second.read_only)
+	{
+		session_database = database->getReadDatabase();
+	}
+
+	Poco::Data::SessionPool::SessionList::iterator session_itr;
+	Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(session_database, session_itr);
+	DBSessionPutback putback(extension, session_database, session_itr);
+
+	Poco::Data::SessionPool::StatementCache *statement_cache = session_itr->second.find(sql);
+	if (statement_cache == nullptr)
+	{
+		Poco::Data::SessionPool::StatementCache new_statement_cache;
+		Poco::Timestamp prepare_start;
+		try
+		{
+			Poco::Data::Statement sql_statement(session);
+			sql_statement << sql;
+			sql_statement.extDB_prepare();
+			new_statement_cache.push_back(std::move(sql_statement));
+			statement_cache = &(session_itr->second.insert(sql, new_statement_cache, prepare_start.elapsed()));
+		}
+		catch (Poco::Exception& e)
+		{
+			status = false;
+			#ifdef TESTING
+				std::cout << "extDB: DB_CUSTOM_V5: Error Preparing Statement: " + e.displayText() << std::endl;
+			#endif
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Preparing Statement: " + e.displayText();
+			result = "[0,\"Error Exception\"]";
+		}
+	}
+
+	if (status)
+	{
+		Poco::Data::Statement &sql_statement = (*statement_cache)[0];
+		sql_statement.bindClear();
+		for (std::size_t i = 0; i < placeholders; ++i)
+		{
+			sql_statement, Poco::Data::use(unique_keys[std::min(i, unique_keys.size() - 1)]);
+		}
+		sql_statement.bindFixup();
+
+		executeSQL(extension, session_database, session_itr, sql_statement, result, status);
+		if (status)
+		{
+			Poco::Data::RecordSet rs(sql_statement);
+			const std::size_t cols = rs.columnCount();
+			const std::size_t key_col = (std::size_t) (itr->second.batch_key_column - 1);
+			if (key_col >= cols)
+			{
+				status = false;
+				BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Batch Key Column: " << itr->first;
+				result = "[0,\"Error Batch Key Column\"]";
+			}
+			else
+			{
+				bool more = rs.moveFirst();
+				Poco::Int64 row_key;
+				while (more)
+				{
+					std::unordered_map< std::string, std::size_t >::const_iterator key_itr = key_index.end();
+					if (Poco::NumberParser::tryParse64(rs[key_col].convert<std::string>(), row_key))
+					{
+						key_itr = key_index.find(Poco::NumberFormatter::format(row_key));
+					}
+					if (key_itr != key_index.end())
+					{
+						std::string &rows = key_rows[key_itr->second];
+						bool sanitize_value_check = true;
+						if (!rows.empty())
+						{
+							rows += ",";
+						}
+						rows += "[";
+						for (std::size_t col = 0; col < cols; ++col)
+						{
+							std::string temp_str = rs[col].convert<std::string>();
+							getValue(itr->second, col, temp_str, (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING), rows, sanitize_value_check);
+							if (col < (cols - 1))
+							{
+								rows += ",";
+							}
+						}
+						rows += "]";
+						if (!sanitize_value_check)
+						{
+							key_sanitize_value_check[key_itr->second] = false;
+						}
+					}
+					more = rs.moveNext();
+				}
+			}
+		}
+		else
+		{
+			session_itr->second.erase(sql);
+		}
+	}
+
+	results.resize(keys.size());
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		const std::size_t key = key_index[keys[i]];
+		if (!status)
+		{
+			results[i] = result;
+		}
+		else if (!key_sanitize_value_check[key])
+		{
+			results[i] = "[0,\"Error Values Input is not sanitized\"]";
+		}
+		else
+		{
+			results[i] = "[1,[" + key_rows[key] + "]]";
+		}
+	}
+}
+
+
+void DB_CUSTOM_V5::getBatchStats(std::string &result)
+// [1,[Batches,Batched Calls,Average Batch Size,Max Batch Size,Query Time ms]] of all Batch Template Calls
+{
+	Poco::UInt64 batches = 0;
+	Poco::UInt64 batched_calls = 0;
+	Poco::UInt64 max_batch_size = 0;
+	Poco::Int64 query_time = 0;
+	for (std::unordered_map<std::string, boost::shared_ptr<Batch_Queue> >::const_iterator itr = batch_queues.begin(); itr != batch_queues.end(); ++itr)
+	{
+		boost::lock_guard<boost::mutex> lock(itr->second->mutex);
+		batches += itr->second->batches;
+		batched_calls += itr->second->batched_calls;
+		max_batch_size = std::max(max_batch_size, itr->second->max_batch_size);
+		query_time += itr->second->query_time;
 	}
+	result = "[1,[" + Poco::NumberFormatter::format(batches) + "," +
+				Poco::NumberFormatter::format(batched_calls) + "," +
+				Poco::NumberFormatter::format((batches > 0) ? (batched_calls / batches) : 0) + "," +
+				Poco::NumberFormatter::format(max_batch_size) + "," +
+				Poco::NumberFormatter::format(query_time / 1000) + "]]";
+}
 
-	extension->putbackDBSession_mutexlock(session_itr);
 
+void DB_CUSTOM_V5::logCustomProtocol(AbstractExt *extension, std::string &input_str, std::string &result, bool status)
+{
 	if (!status)
 	{
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Exception: SQL:" + input_str;
@@ -688,6 +1459,14 @@ void DB_CUSTOM_V5::callCustomProtocol(AbstractExt *extension, std::string call_n
 
 
 void DB_CUSTOM_V5::callProtocol(AbstractExt *extension, std::string input_str, std::string &result)
+{
+	callProtocol(extension, input_str, result, nullptr);
+}
+
+
+bool DB_CUSTOM_V5::processInputs(AbstractExt *extension, std::string &input_str, std::unordered_map<std::string, Template_Call>::const_iterator &itr, std::vector< std::string > &inputs, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &result)
+// Finds Call + runs Input Options on every Input
+//	false = Error, Error Message is in result
 {
 	#ifdef TESTING
 		std::cout << "extDB: DB_CUSTOM_V5: Trace: " + input_str << std::endl;
@@ -697,120 +1476,208 @@ void DB_CUSTOM_V5::callProtocol(AbstractExt *extension, std::string input_str, s
 	#endif
 
 	Poco::StringTokenizer tokens(input_str, ":");
-	std::unordered_map<std::string, Template_Call>::const_iterator itr = custom_protocol.find(tokens[0]);
+	itr = custom_protocol.find(tokens[0]);
 
 	if (itr == custom_protocol.end())
 	{
 		// NO CALLNAME FOUND IN PROTOCOL
 		result = "[0,\"Error No Custom Call Not Found\"]";
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error No Custom Call Not Found: " + input_str;
+		return false;
 	}
-	else
+
+	// CALLNAME FOUND IN PROTOCOL
+	if (itr->second.number_of_inputs != (tokens.count() - 1))
+	{
+		// BAD Number of Inputs
+		result = "[0,\"Error Incorrect Number of Inputs\"]";
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Incorrect Number of Inputs: " + input_str;
+		return false;
+	}
+
+	// GOOD Number of Inputs
+	bool bad_chars_detected = false;
+	bool sanitize_value_check_ok = true;
+
+	if (itr->second.bad_chars_action > 0)
 	{
-		// CALLNAME FOUND IN PROTOCOL
-		if (itr->second.number_of_inputs != (tokens.count() - 1))
+		// Strip Chars
+		std::string temp_str;
+		for (std::vector<std::string>::const_iterator token_itr = tokens.begin(); token_itr != tokens.end(); ++token_itr)
 		{
-			// BAD Number of Inputs
-			result = "[0,\"Error Incorrect Number of Inputs\"]";
-			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Incorrect Number of Inputs: " + input_str;
+			temp_str = *token_itr;
+			for (int i = 0; (i < (itr->second.bad_chars.size() - 1)); ++i)
+			{
+				boost::erase_all(temp_str, std::string(1, itr->second.bad_chars[i]));
+			}
+			inputs.push_back(temp_str);
+			if (temp_str != *token_itr)
+			{
+				bad_chars_detected = true;
+			}
 		}
-		else
-		{
-			// GOOD Number of Inputs
-			bool bad_chars_detected = false;
-			bool sanitize_value_check_ok = true;
+	}
+	else
+	{
+		// DONT Strip Chars
+		inputs.insert(inputs.end(), tokens.begin(), tokens.end());
+	}
 
-			std::vector< std::string > inputs;
+	// Multiple INPUT Lines
+	std::vector<std::string>::size_type num_inputs = inputs.size();	
+	std::vector<std::string>::size_type num_sql_inputs_options = itr->second.sql_inputs_options.size();
 
-			if (itr->second.bad_chars_action > 0)
+	for(int i = 0; i < num_sql_inputs_options; ++i)
+	{
+		std::vector< std::string > processed_inputs;
+		processed_inputs.clear();
+
+		for(int x = 0; x < itr->second.sql_inputs_options[i].size(); ++x)
+		{
+			if (itr->second.sql_inputs_options[i][x].sql_line > 0)
 			{
-				// Strip Chars
-				std::string temp_str;
-				for (std::vector<std::string>::const_iterator token_itr = tokens.begin(); token_itr != tokens.end(); ++token_itr)
+				// SQLm.c Input, set by callCustomProtocol once SQL Line m has run
+				processed_inputs.push_back(std::string());
+			}
+			else if (itr->second.number_of_inputs > 0)
+			{
+				std::string temp_str = inputs[itr->second.sql_inputs_options[i][x].number];
+				// INPUT Options
+					// BEGUID					
+				if (itr->second.sql_inputs_options[i][x].beguid)
+				{
+					getBEGUID(temp_str, temp_str);
+				}
+					// STRING
+				if (itr->second.sql_inputs_options[i][x].string)
 				{
-					temp_str = *token_itr;
-					for (int i = 0; (i < (itr->second.bad_chars.size() - 1)); ++i)
+					if (temp_str.empty())
 					{
-						boost::erase_all(temp_str, std::string(1, itr->second.bad_chars[i]));
+						temp_str = ("\"\"");
 					}
-					inputs.push_back(temp_str);
-					if (temp_str != *token_itr)
+					else
 					{
-						bad_chars_detected = true;
+						temp_str = "\"" + temp_str + "\"";
 					}
 				}
-			}
-			else
-			{
-				// DONT Strip Chars
-				inputs.insert(inputs.end(), tokens.begin(), tokens.end());
-			}
-
-			// Multiple INPUT Lines
-			std::vector<std::string>::size_type num_inputs = inputs.size();	
-			std::vector<std::string>::size_type num_sql_inputs_options = itr->second.sql_inputs_options.size();
-
-			std::vector< std::vector< std::string > > all_processed_inputs;
-
-			for(int i = 0; i < num_sql_inputs_options; ++i)
-			{
-				std::vector< std::string > processed_inputs;
-				processed_inputs.clear();
 
-				if (itr->second.number_of_inputs > 0)
+					// SANITIZE CHECK
+				if (itr->second.sql_inputs_options[i][x].check)
 				{
-					for(int x = 0; x < itr->second.sql_inputs_options[i].size(); ++x)
+					if (!Sqf::check(temp_str))
 					{
-						std::string temp_str = inputs[itr->second.sql_inputs_options[i][x].number];
-						// INPUT Options
-							// BEGUID					
-						if (itr->second.sql_inputs_options[i][x].beguid)
-						{
-							getBEGUID(temp_str, temp_str);
-						}
-							// STRING
-						if (itr->second.sql_inputs_options[i][x].string)
-						{
-							if (temp_str.empty())
-							{
-								temp_str = ("\"\"");
-							}
-							else
-							{
-								temp_str = "\"" + temp_str + "\"";
-							}
-						}
-
-							// SANITIZE CHECK
-						if (itr->second.sql_inputs_options[i][x].check)
-						{
-							if (!Sqf::check(temp_str))
-							{
-								sanitize_value_check_ok = false;
-							}
-						}
-						processed_inputs.push_back(std::move(temp_str));
+						sanitize_value_check_ok = false;
 					}
 				}
-				all_processed_inputs.push_back(std::move(processed_inputs));
+				processed_inputs.push_back(std::move(temp_str));
+			}
+		}
+		all_processed_inputs.push_back(std::move(processed_inputs));
+	}
+
+	if (bad_chars_detected)
+	{
+		result = "[0,\"Error Bad Char Found\"]";
+		return false;
+	}
+	if (!(sanitize_value_check_ok))
+	{
+		result = "[0,\"Error Values Input is not sanitized\"]";
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Sanitize Check error: Input:" + input_str;
+		return false;
+	}
+	return true;
+}
+
+
+void DB_CUSTOM_V5::callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream)
+{
+	std::unordered_map<std::string, Template_Call>::const_iterator itr;
+	std::vector< std::string > inputs;
+	std::vector< std::vector< std::string > > all_processed_inputs;
+
+	if (processInputs(extension, input_str, itr, inputs, all_processed_inputs, result))
+	{
+		// Output Sanitize Check replaces whole Result on failure, so those Calls aren't streamed
+		for (std::vector< Value_Options >::const_iterator option_itr = itr->second.sql_outputs_options.begin(); option_itr != itr->second.sql_outputs_options.end(); ++option_itr)
+		{
+			if (option_itr->check)
+			{
+				stream = nullptr;
+				break;
 			}
+		}
 
-			if (!(bad_chars_detected))
+		try
+		{
+			if (itr->second.broadcast)
 			{
-				if (sanitize_value_check_ok)
-				{
-					callCustomProtocol(extension, tokens[0], itr, all_processed_inputs, input_str, result);
-				}
-				else
-				{
-					result = "[0,\"Error Values Input is not sanitized\"]";
-					BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Sanitize Check error: Input:" + input_str;
-				}
+				broadcastCustomProtocol(extension, itr->first, itr, all_processed_inputs, input_str, result);
+			}
+			else if (itr->second.batch_window > 0)
+			{
+				batchCallProtocol(extension, itr, input_str, all_processed_inputs[0][0], result);
+			}
+			else if (itr->second.shard_key > 0)
+			{
+				callCustomProtocol(extension, database->getShard(inputs[itr->second.shard_key]), itr->first, itr, all_processed_inputs, input_str, result, stream);
 			}
 			else
 			{
-				result = "[0,\"Error Bad Char Found\"]";
+				callCustomProtocol(extension, database, itr->first, itr, all_processed_inputs, input_str, result, stream);
 			}
 		}
+		catch (Poco::Exception& e)
+		{
+			// DB Session Checkout, i.e SessionPoolExhaustedException after Checkout Timeout
+			#ifdef TESTING
+				std::cout << "extDB: DB_CUSTOM_V5: Error Exception: " + e.displayText() << std::endl;
+			#endif
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Exception: " + e.displayText();
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_CUSTOM_V5: Error Exception: Input:" + input_str;
+			result = "[0,\"Error Exception\"]";
+		}
+	}
+}
+
+
+boost::shared_ptr<ResultCursor> DB_CUSTOM_V5::openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result)
+// Cursor on last SQL Statement of Call, Shard Key + Read Only Options same as callProtocol
+//	Broadcast, Flow, Transaction + Row Info Calls aren't supported, Cursors always run on Poco (no Native Backend)
+{
+	boost::shared_ptr<DBCursor> cursor;
+	std::unordered_map<std::string, Template_Call>::const_iterator itr;
+	std::vector< std::string > inputs;
+	std::vector< std::vector< std::string > > all_processed_inputs;
+
+	if (processInputs(extension, input_str, itr, inputs, all_processed_inputs, result))
+	{
+		if (itr->second.broadcast || itr->second.flow || itr->second.transaction || (!itr->second.row_info_outputs.empty()))
+		{
+			result = "[0,\"Error Cursor not supported\"]";
+		}
+		else
+		{
+			DBConnectionInfo *session_database = database;
+			if (itr->second.shard_key > 0)
+			{
+				session_database = database->getShard(inputs[itr->second.shard_key]);
+			}
+			if (itr->second.read_only)
+			{
+				session_database = session_database->getReadDatabase();
+			}
+
+			const Template_Call &template_call = itr->second;
+			cursor.reset(new DBCursor(extension, session_database, page_size,
+				[this, &template_call](std::size_t col, std::string &value, bool string_type, std::string &value_result) -> bool
+				{
+					bool sanitize_value_check = true;
+					getValue(template_call, col, value, string_type, value_result, sanitize_value_check);
+					return sanitize_value_check;
+				}));
+			cursor->open(template_call.sql_prepared_statements, all_processed_inputs);
+		}
 	}
+	return cursor;
 }
@@ -18,6 +18,8 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <Poco/DynamicAny.h>
@@ -35,6 +37,9 @@ class DB_CUSTOM_V5: public AbstractProtocol
 	public:
 		bool init(AbstractExt *extension, const std::string init_str);
 		void callProtocol(AbstractExt *extension, std::string input_str, std::string &result);
+		void callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream);
+		boost::shared_ptr<ResultCursor> openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result);
+		void getBatchStats(std::string &result);
 		
 	private:
 		Poco::MD5Engine md5;
@@ -50,8 +55,13 @@ class DB_CUSTOM_V5: public AbstractProtocol
 			bool beguid = false;
 			bool string = false;
 			bool string_datatype_check = false;
+
+			int sql_line = 0;  // Input is a Column of first Row of an earlier SQL Line i.e SQL1.2, 0 = Call Input
+			int sql_column = 0;
 		};
 		
+		enum Row_Info { AFFECTED_ROWS, INSERT_ID };
+
 		struct Template_Call {
 			int number_of_inputs;
 			bool string_datatype_check;
@@ -61,7 +71,30 @@ class DB_CUSTOM_V5: public AbstractProtocol
 			bool input_sanitize_value_check;
 			bool output_sanitize_value_check;
 
+			bool read_only = false;  // Runs on Read Replica if available
+			int shard_key = 0;  // Input Number used to pick Shard, 0 = Shard 0
+			bool broadcast = false;  // Runs on every Shard, Results are merged
+
+			// Flow -- SQLn_IF_EMPTY / Return SQL / SQLm.c Inputs, runs on Poco only
+			bool flow = false;
+			std::vector< int > sql_if_empty;  // SQL Line runs only if this SQL Line (1..) returned / affected 0 Rows (MySQL UPDATE = changed Rows), 0 = always runs
+			int return_sql = 0;  // SQL Line whose Rows are returned, 0 = last
+
+			// Transaction = true -- SQL Lines run in one Transaction, rolled back if one fails, runs on Poco only
+			bool transaction = false;
+
+			// OUTPUT = AFFECTED_ROWS / INSERT_ID, returns [1,[..]] of returned SQL Line instead of its Rows
+			std::vector< Row_Info > row_info_outputs;
+
+			// Batch -- Concurrent Calls are collected for Batch Window ms + run as one WHERE key IN (...) Query, 0 = Disabled
+			int batch_window = 0;
+			int batch_max = 0;
+			int batch_key_column = 0;  // Output Column (1..) holding the Key, Rows are matched back to Calls by it
+			std::string batch_sql_prefix;  // SQL before "= ?"
+			std::string batch_sql_suffix;  // SQL after "?"
+
 			std::vector< std::string > sql_prepared_statements;
+			std::string sql_cache_key;
 
 			std::vector< std::vector< Value_Options > > sql_inputs_options;
 			std::vector< Value_Options > sql_outputs_options;
@@ -69,9 +102,40 @@ class DB_CUSTOM_V5: public AbstractProtocol
 
 		std::unordered_map<std::string, Template_Call> custom_protocol;
 
-		void callCustomProtocol(AbstractExt *extension, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result);
-		void executeSQL(AbstractExt *extension, Poco::Data::Statement &sql_statement, std::string &result, bool &status);
+		struct Batch {
+			std::vector< std::string > keys;  // Key of each Call, Call = Index
+			std::vector< std::string > results;
+			bool done = false;
+		};
+
+		struct Batch_Queue {
+			boost::mutex mutex;
+			boost::condition_variable condition;
+			boost::shared_ptr<Batch> collecting;  // Batch still taking Calls, nullptr = next Call starts a new Batch
+
+			Poco::UInt64 batches = 0;
+			Poco::UInt64 batched_calls = 0;
+			Poco::UInt64 max_batch_size = 0;
+			Poco::Int64 query_time = 0;  // microseconds
+		};
+
+		std::unordered_map<std::string, boost::shared_ptr<Batch_Queue> > batch_queues;  // Call Name -> Batch Queue, only modified in init
+
+		bool processInputs(AbstractExt *extension, std::string &input_str, std::unordered_map<std::string, Template_Call>::const_iterator &itr, std::vector< std::string > &inputs, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &result);
+		bool warmupStatements(AbstractExt *extension, Poco::Data::Session &session, Poco::Data::StatementLRUCache &statement_cache_lru);
+
+		void broadcastCustomProtocol(AbstractExt *extension, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result);
+		void callCustomProtocol(AbstractExt *extension, DBConnectionInfo *call_database, std::string call_name, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &input_str, std::string &result, ResultStream *stream);
+		std::size_t executeSQL(AbstractExt *extension, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr, Poco::Data::Statement &sql_statement, std::string &result, bool &status);
+		void transactionSQL(AbstractExt *extension, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr, Poco::Data::Session &session, const std::string &sql_str, std::string &result, bool &status);
+		bool nativeCustomProtocol(AbstractExt *extension, DBConnectionInfo *session_database, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::vector< std::vector< std::string > > &all_processed_inputs, std::string &result, ResultStream *stream, bool &status);
+		void batchCallProtocol(AbstractExt *extension, std::unordered_map<std::string, Template_Call>::const_iterator itr, std::string &input_str, const std::string &key, std::string &result);
+		void batchCustomProtocol(AbstractExt *extension, std::unordered_map<std::string, Template_Call>::const_iterator itr, const std::vector< std::string > &keys, std::vector< std::string > &results);
+		void logCustomProtocol(AbstractExt *extension, std::string &input_str, std::string &result, bool status);
 
 		void getBEGUID(std::string &input_str, std::string &result);
-		void getResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, Poco::Data::Statement &sql_statement, std::string &result);
+		void getValue(const Template_Call &template_call, std::size_t col, std::string &temp_str, bool string_type, std::string &result, bool &sanitize_value_check);
+		void getResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, Poco::Data::Statement &sql_statement, std::string &result, ResultStream *stream);
+		void getRowInfoResult(std::unordered_map<std::string, Template_Call>::const_iterator itr, unsigned long long affected_rows, unsigned long long insert_id, std::string &result);
+		unsigned long long lastInsertID(Poco::Data::Session &session, DBConnectionInfo *session_database, Poco::Data::SessionPool::SessionList::iterator &session_itr);
 };
\ No newline at end of file
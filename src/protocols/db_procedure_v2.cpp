@@ -26,22 +26,28 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <Poco/Data/MySQL/MySQLException.h>
 
 #include <Poco/Exception.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
 #include <Poco/StringTokenizer.h>
+#include <Poco/Timestamp.h>
+
+#include <boost/algorithm/string.hpp>
 
 #ifdef TEST_APP
 	#include <iostream>
 #endif
 
+#include "../backends/native_pool.h"
 #include "../sanitize.h"
 
 
 bool DB_PROCEDURE_V2::init(AbstractExt *extension, const std::string init_str)
 {
-	if (extension->getDBType() == std::string("MySQL"))
+	if (extension->getDBType(database) == std::string("MySQL"))
 	{
 		return true;
 	}
-	else if (extension->getDBType() == std::string("SQLite"))
+	else if (extension->getDBType(database) == std::string("SQLite"))
 	{
 		// SQLITE Doesn't Support Procedures
 		#ifdef TESTING
@@ -77,6 +83,49 @@ return status;
 }
 
 
+std::string DB_PROCEDURE_V2::getValue(const std::string &sqf_value)
+// SQF Value as Bind Value, Strings lose their Quotes ("" = ") + true / false = 1 / 0
+{
+	const std::string value = boost::algorithm::trim_copy(sqf_value);
+	if ((value.size() >= 2) && ((value[0] == '"') || (value[0] == '\'')) && (value[value.size() - 1] == value[0]))
+	{
+		std::string str = value.substr(1, (value.size() - 2));
+		boost::algorithm::replace_all(str, std::string(2, value[0]), std::string(1, value[0]));
+		return str;
+	}
+	else if (boost::iequals(value, std::string("true")))
+	{
+		return "1";
+	}
+	else if (boost::iequals(value, std::string("false")))
+	{
+		return "0";
+	}
+	return value;
+}
+
+
+std::string DB_PROCEDURE_V2::getCallSQL(const std::string &procedure, std::size_t num_of_inputs, int num_of_outputs, bool native)
+// CALL procedure(?,?,OUT), Native = OUT Parameters are ? Placeholders, else Session Variables @extDB_OutputN
+{
+	std::string sql_str = "CALL " + procedure + "(";
+	for (std::size_t i = 0; i < num_of_inputs; ++i)
+	{
+		sql_str += (i > 0) ? ",?" : "?";
+	}
+	for (int i = 0; i < num_of_outputs; ++i)
+	{
+		if ((num_of_inputs > 0) || (i > 0))
+		{
+			sql_str += ",";
+		}
+		sql_str += native ? "?" : ("@extDB_Output" + Poco::NumberFormatter::format(i));
+	}
+	sql_str += ")";
+	return sql_str;
+}
+
+
 void DB_PROCEDURE_V2::callProtocol(AbstractExt *extension, std::string input_str, std::string &result)
 {
 //  Unique ID
@@ -86,6 +135,8 @@ void DB_PROCEDURE_V2::callProtocol(AbstractExt *extension, std::string input_str
 //  Input
 //   |
 //  Output Count
+//   |
+//  BATCH / BATCH_ABORT (optional) -- Input is an Array of Input Arrays i.e [[1,"abc"],[2,"def"]]
 	#ifdef TESTING
 		std::cout << "extDB: DB_PROCEDURE_V2: Trace: " + input_str << std::endl;
 	#endif
@@ -97,15 +148,26 @@ void DB_PROCEDURE_V2::callProtocol(AbstractExt *extension, std::string input_str
 	{
 		Poco::StringTokenizer t_arg(input_str, "|");
 		const int num_of_inputs = t_arg.count();
-		if ((num_of_inputs == 4) && (t_arg[1].length() >= 3) && (isNumber(t_arg[0])))
+		if ((num_of_inputs == 5) && (t_arg[1].length() >= 3) && (isNumber(t_arg[0])) && (boost::iequals(t_arg[4], std::string("BATCH")) || boost::iequals(t_arg[4], std::string("BATCH_ABORT"))))
+		{
+			if (Sqf::check(t_arg[1]))
+			{
+				callBatch(extension, t_arg[1].substr(1, (t_arg[1].length() - 2)), t_arg[2], Poco::NumberParser::parse(t_arg[3]), boost::iequals(t_arg[4], std::string("BATCH_ABORT")), result);
+			}
+			else
+			{
+				result = "[0,\"Invalid Value for Unique Server ID / Procedure Name \"]";
+			}
+		}
+		else if ((num_of_inputs == 4) && (t_arg[1].length() >= 3) && (isNumber(t_arg[0])))
 		{
-			std::string sql_str_procedure = "call " + t_arg[1].substr(1, (t_arg[1].length() - 2)) + "(";
-			std::string sql_str_select = "SELECT ";
-
 			if ( (Sqf::check(t_arg[0])) && (Sqf::check(t_arg[1])) )
 			{
-				// Inputs
+				const std::string procedure = t_arg[1].substr(1, (t_arg[1].length() - 2));
+
+				// Inputs, bound as Parameters
 				bool sanitize_check = true;
+				std::vector<std::string> inputs;
 				Poco::StringTokenizer t_arg_inputs(t_arg[2], ":");
 				const int num_of_inputs = t_arg_inputs.count();
 				for(int i = 0; i != num_of_inputs; ++i) {
@@ -114,108 +176,46 @@ void DB_PROCEDURE_V2::callProtocol(AbstractExt *extension, std::string input_str
 						sanitize_check = false;
 						break;
 					}
-					sql_str_procedure += t_arg_inputs[i] + ",";
+					inputs.push_back(getValue(t_arg_inputs[i]));
 				}
-				
+
 				if (sanitize_check)
 				{
 					// Outputs
 					const int num_of_outputs = Poco::NumberParser::parse(t_arg[3]);
-					if (num_of_outputs <= 0)
-					{
-						if (num_of_inputs > 0)
-						{
-							// Remove the trailing "," if no outputs
-							sql_str_procedure = sql_str_procedure.substr(0,(sql_str_procedure.length() - 1));  
-						}
-						sql_str_procedure += ")";
-					}
-					else
+
+					// Native Backend -- OUT Parameters are returned with the CALL in one Round Trip
+					//	Rows are the OUT Parameters like the Poco Path (SELECT @extDB_Output), or the first Result Set of the Procedure if there are no Outputs
+					bool native = false;
+					if (database->useNative())
 					{
-						// Generate Output Values
-						unique_id = extension->getUniqueID_mutexlock(); // Using this to make sure no clashing of Output Values
-						for(int i = 0; i != num_of_outputs; ++i) {
-							const std::string temp_str = "@Output" + Poco::NumberFormatter::format(i) + "_" + Poco::NumberFormatter::format(unique_id) +  + "_" + t_arg[0] + ",";
-							sql_str_procedure += temp_str;
-							sql_str_select += temp_str;
-						}
-						// Remove the trailing ","
-						sql_str_procedure = sql_str_procedure.substr(0,(sql_str_procedure.length() - 1));  // Remove the trailing ", " if there is outputs
-						sql_str_select = sql_str_select.substr(0,(sql_str_select.length() - 1));
-						sql_str_procedure += ")";
+						std::vector<std::string> native_inputs(inputs);
+						native_inputs.resize(inputs.size() + ((num_of_outputs > 0) ? num_of_outputs : 0));
+						native = database->native->execute(getCallSQL(procedure, inputs.size(), num_of_outputs, true), native_inputs, (NativePool::QUOTE_STRINGS | NativePool::QUOTE_EMPTY | ((num_of_outputs > 0) ? NativePool::OUT_PARAMS : 0)), result, nullptr);
 					}
 
-					// SQL Call Statement
-					Poco::Data::Session db_session = extension->getDBSession_mutexlock();
-					Poco::Data::Statement sql(db_session);
-
-					sql << sql_str_procedure, Poco::Data::now;
-
-					result = "[1,[";
-
-					if (num_of_outputs > 0)
+					if (!native)
 					{
-						// If Outputs.. SQL SELECT Statement to get Results
-						
-						Poco::Data::Statement sql2(db_session);
-						sql2 << sql_str_select, Poco::Data::now;
-							
-						extension->freeUniqueID_mutexlock(unique_id); // Free Unique ID
-							
-						Poco::Data::RecordSet rs(sql2);
-						
-						std::size_t cols = rs.columnCount();
-						if (cols >= 1)
+						Poco::Data::SessionPool::SessionList::iterator session_itr;
+						Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(database, session_itr);
+						try
+						{
+							callProcedure(session, session_itr, procedure, inputs, num_of_outputs, result);
+						}
+						catch (Poco::Data::MySQL::ConnectionException&)
 						{
-							bool more = rs.moveFirst();
-							while (more)
-							{
-								result += "[";
-								for (std::size_t col = 0; col < cols; ++col)
-								{
-									std::string temp_str = rs[col].convert<std::string>();
-									
-									if (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING)
-									{
-										if (temp_str.empty())
-										{
-											result += ("\"\"");
-										}
-										else
-										{
-											result += "\"" + temp_str + "\"";
-										}
-									}
-									else
-									{
-										if (temp_str.empty())
-										{
-											result += ("\"\"");
-										}
-										else
-										{
-											result += temp_str;
-										}
-									}
-									if (col < (cols - 1))
-									{
-										result += ",";
-									}
-								}
-
-								more = rs.moveNext();
-								if (more)
-								{
-									result += "],";
-								}
-								else
-								{
-									result += "]";
-								}
-							}
+							// Broken DB Session, close it instead of putting it back
+							extension->invalidateDBSessionCustom_mutexlock(database, session_itr);
+							extension->putbackDBSession_mutexlock(database, session_itr);
+							throw;
 						}
+						catch (Poco::Exception&)
+						{
+							extension->putbackDBSession_mutexlock(database, session_itr);
+							throw;
+						}
+						extension->putbackDBSession_mutexlock(database, session_itr);
 					}
-					result += "]]";
 
 					#ifdef TESTING
 						std::cout << "extDB: DB_PROCEDURE_V2: Trace: Result: " + result << std::endl;
@@ -255,4 +255,274 @@ void DB_PROCEDURE_V2::callProtocol(AbstractExt *extension, std::string input_str
 		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_PROCEDURE_V2: Error Exception: Input:" + input_str;
 		result = "[0,\"Error Exception\"]";
 	}
-}
\ No newline at end of file
+}
+
+
+void DB_PROCEDURE_V2::callBatch(AbstractExt *extension, const std::string &procedure, const std::string &batch_str, int num_of_outputs, bool abort, std::string &result)
+// Runs Procedure once per Input Array on one DB Session inside one Transaction, Prepared CALL is reused for every Item
+//	Result = [1,[ITEM_RESULT,ITEM_RESULT,..]], Item Result is same as a single Call i.e [1,[[..]]] or [0,"Error Exception"]
+//	BATCH = Failed Item is rolled back to a Savepoint before it, other Items are kept
+//	BATCH_ABORT = First failed Item rolls back the Transaction, Result = [0,"Error Batch Aborted",ITEM_INDEX]
+//	Error that rolled back the Transaction (i.e Deadlock) aborts a BATCH too, Items before it were lost
+//	DB Session already in a Transaction (Journal Batch) = Batch uses a Savepoint instead of its own Transaction
+{
+	// Inputs, every Item is an Array of SQF Values
+	std::vector< std::vector<std::string> > batch_inputs;
+	Sqf::Value batch_value;
+	std::vector<Sqf::Value> *items = nullptr;
+	if (Sqf::parse(batch_str, batch_value))
+	{
+		items = boost::get< std::vector<Sqf::Value> >(&batch_value);
+	}
+	if (items != nullptr)
+	{
+		for (std::vector<Sqf::Value>::iterator item_itr = items->begin(); item_itr != items->end(); ++item_itr)
+		{
+			std::vector<Sqf::Value> *values = boost::get< std::vector<Sqf::Value> >(&(*item_itr));
+			if (values == nullptr)
+			{
+				items = nullptr;
+				break;
+			}
+			batch_inputs.push_back(std::vector<std::string>());
+			for (std::vector<Sqf::Value>::iterator value_itr = values->begin(); value_itr != values->end(); ++value_itr)
+			{
+				if (std::string *value_str = boost::get<std::string>(&(*value_itr)))
+				{
+					batch_inputs.back().push_back(*value_str);
+				}
+				else if (int *value_int = boost::get<int>(&(*value_itr)))
+				{
+					batch_inputs.back().push_back(Poco::NumberFormatter::format(*value_int));
+				}
+				else if (Poco::Int64 *value_int64 = boost::get<Poco::Int64>(&(*value_itr)))
+				{
+					batch_inputs.back().push_back(Poco::NumberFormatter::format(*value_int64));
+				}
+				else if (double *value_double = boost::get<double>(&(*value_itr)))
+				{
+					batch_inputs.back().push_back(Poco::NumberFormatter::format(*value_double));
+				}
+				else if (bool *value_bool = boost::get<bool>(&(*value_itr)))
+				{
+					batch_inputs.back().push_back(*value_bool ? "1" : "0");
+				}
+				else
+				{
+					// Nested Array / any
+					items = nullptr;
+					break;
+				}
+			}
+			if (items == nullptr)
+			{
+				break;
+			}
+		}
+	}
+	if (items == nullptr)
+	{
+		result = "[0,\"Invalid Format\"]";
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_PROCEDURE_V2: Batch: Invalid Format: " + batch_str;
+		return;
+	}
+
+	Poco::Data::SessionPool::SessionList::iterator session_itr;
+	Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(database, session_itr);
+	const bool nested = session.isTransaction();
+	try
+	{
+		if (nested)
+		{
+			session << "SAVEPOINT extDB_Batch", Poco::Data::now;
+		}
+		else
+		{
+			session.begin();
+		}
+		bool aborted = false;
+		std::string item_result;
+		result = "[1,[";
+		for (std::vector< std::vector<std::string> >::size_type i = 0; i < batch_inputs.size(); ++i)
+		{
+			if (!abort)
+			{
+				session << "SAVEPOINT extDB_BatchItem", Poco::Data::now;
+			}
+			try
+			{
+				callProcedure(session, session_itr, procedure, batch_inputs[i], num_of_outputs, item_result);
+			}
+			catch (Poco::Data::MySQL::ConnectionException&)
+			{
+				throw;
+			}
+			catch (Poco::Exception& e)
+			{
+				BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_PROCEDURE_V2: Batch: Error Exception: Item " << i << ": " + e.displayText();
+				bool rolled_back = abort;
+				if (!abort)
+				{
+					try
+					{
+						session << "ROLLBACK TO SAVEPOINT extDB_BatchItem", Poco::Data::now;
+					}
+					catch (Poco::Data::MySQL::ConnectionException&)
+					{
+						throw;
+					}
+					catch (Poco::Exception&)
+					{
+						// Savepoint is gone, Server rolled back the Transaction (Deadlock / Lock Wait Timeout with innodb_rollback_on_timeout)
+						rolled_back = true;
+					}
+				}
+				if (rolled_back)
+				{
+					if (nested)
+					{
+						session << "ROLLBACK TO SAVEPOINT extDB_Batch", Poco::Data::now;
+					}
+					else
+					{
+						session.rollback();
+					}
+					aborted = true;
+					result = "[0,\"Error Batch Aborted\"," + Poco::NumberFormatter::format(i) + "]";
+					break;
+				}
+				item_result = "[0,\"Error Exception\"]";
+			}
+			if (i > 0)
+			{
+				result += ",";
+			}
+			result += item_result;
+		}
+		if (!aborted)
+		{
+			if (!nested)
+			{
+				session.commit();
+			}
+			result += "]]";
+		}
+	}
+	catch (Poco::Data::MySQL::ConnectionException&)
+	{
+		// Broken DB Session, close it instead of putting it back -- Transaction is rolled back by the Server
+		extension->invalidateDBSessionCustom_mutexlock(database, session_itr);
+		extension->putbackDBSession_mutexlock(database, session_itr);
+		throw;
+	}
+	catch (Poco::Exception&)
+	{
+		if ((!nested) && session.isTransaction())
+		{
+			session.rollback();
+		}
+		extension->putbackDBSession_mutexlock(database, session_itr);
+		throw;
+	}
+	extension->putbackDBSession_mutexlock(database, session_itr);
+}
+
+void DB_PROCEDURE_V2::callProcedure(Poco::Data::Session &session, Poco::Data::SessionPool::SessionList::iterator &session_itr, const std::string &procedure, std::vector<std::string> &inputs, int num_of_outputs, std::string &result)
+// Runs Prepared CALL (+ SELECT of OUT Parameters) from Statement Cache of DB Session, cached per Procedure Name + Number of Inputs / Outputs
+//	OUT Parameters are Session Variables, a DB Session only runs one Call at a time so they don't need a Unique ID
+//	Throws on Error, Statements are removed from Statement Cache
+{
+	const std::string sql_str = getCallSQL(procedure, inputs.size(), num_of_outputs, false);
+	try
+	{
+		Poco::Data::SessionPool::StatementCache *statement_cache = session_itr->second.find(sql_str);
+		if (statement_cache == nullptr)
+		{
+			Poco::Data::SessionPool::StatementCache new_statement_cache;
+			Poco::Timestamp prepare_start;
+
+			Poco::Data::Statement sql_call(session);
+			sql_call << sql_str;
+			sql_call.extDB_prepare();
+			new_statement_cache.push_back(std::move(sql_call));
+			if (num_of_outputs > 0)
+			{
+				std::string sql_str_select = "SELECT ";
+				for (int i = 0; i < num_of_outputs; ++i)
+				{
+					if (i > 0)
+					{
+						sql_str_select += ",";
+					}
+					sql_str_select += "@extDB_Output" + Poco::NumberFormatter::format(i);
+				}
+				Poco::Data::Statement sql_select(session);
+				sql_select << sql_str_select;
+				sql_select.extDB_prepare();
+				new_statement_cache.push_back(std::move(sql_select));
+			}
+			statement_cache = &(session_itr->second.insert(sql_str, new_statement_cache, prepare_start.elapsed()));
+		}
+
+		Poco::Data::Statement &sql_call = (*statement_cache)[0];
+		sql_call.bindClear();
+		for (std::vector<std::string>::size_type x = 0; x < inputs.size(); ++x)
+		{
+			sql_call, Poco::Data::use(inputs[x]);
+		}
+		sql_call.bindFixup();
+		sql_call.execute();
+
+		// Outputs = SELECT of OUT Parameters, else Result Set of the CALL (if any)
+		Poco::Data::Statement &sql_result = (*statement_cache)[statement_cache->size() - 1];
+		if (num_of_outputs > 0)
+		{
+			sql_result.execute();
+		}
+		getResult(sql_result, result);
+	}
+	catch (Poco::Exception&)
+	{
+		session_itr->second.erase(sql_str);
+		throw;
+	}
+}
+
+
+void DB_PROCEDURE_V2::getResult(Poco::Data::Statement &sql, std::string &result)
+// Same Output as DB_RAW_V2
+{
+	const NativePool::OptionsWriter writer(NativePool::QUOTE_STRINGS | NativePool::QUOTE_EMPTY);
+	Poco::Data::RecordSet rs(sql);
+
+	result = "[1,[";
+	std::size_t cols = rs.columnCount();
+	if (cols >= 1)
+	{
+		std::string temp_str;
+		bool more = rs.moveFirst();
+		while (more)
+		{
+			result += "[";
+			for (std::size_t col = 0; col < cols; ++col)
+			{
+				if (col > 0)
+				{
+					result += ",";
+				}
+				temp_str = rs[col].convert<std::string>();
+				writer(col, temp_str.data(), temp_str.size(), (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING), result);
+			}
+			more = rs.moveNext();
+			if (more)
+			{
+				result += "],";
+			}
+			else
+			{
+				result += "]";
+			}
+		}
+	}
+	result += "]]";
+}
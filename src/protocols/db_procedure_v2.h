@@ -1,23 +1,8 @@
-/*
-Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
-
-This program is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License as published by
-the Free Software Foundation, either version 3 of the License, or
-(at your option) any later version.
-
-This program is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with this program. If not, see <http://www.gnu.org/licenses/>.
-*/
-
-
 #pragma once
 
+#include <Poco/Data/SessionPool.h>
+#include <Poco/Data/Statement.h>
+
 #include "abstract_ext.h"
 #include "abstract_protocol.h"
 
@@ -30,5 +15,10 @@ class DB_PROCEDURE_V2: public AbstractProtocol
 		
 	private:
 		bool isNumber(const std::string &input_str);
-		int unique_id;
+		std::string getValue(const std::string &sqf_value);
+		std::string getCallSQL(const std::string &procedure, std::size_t num_of_inputs, int num_of_outputs, bool native);
+
+		void callBatch(AbstractExt *extension, const std::string &procedure, const std::string &batch_str, int num_of_outputs, bool abort, std::string &result);
+		void callProcedure(Poco::Data::Session &session, Poco::Data::SessionPool::SessionList::iterator &session_itr, const std::string &procedure, std::vector<std::string> &inputs, int num_of_outputs, std::string &result);
+		void getResult(Poco::Data::Statement &sql, std::string &result);
 };
@@ -28,6 +28,9 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 #include <Poco/Data/SQLite/SQLiteException.h>
 
 #include <Poco/Exception.h>
+#include <Poco/Timestamp.h>
+
+#include "db_cursor.h"
 
 #include <boost/algorithm/string.hpp>
 
@@ -35,15 +38,22 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 	#include <iostream>
 #endif
 
+DB_RAW_V3::DB_RAW_V3(const std::string &name, int quote_options, int protocol_flags):
+	protocol_name(name),
+	flags(protocol_flags),
+	writer(quote_options)
+{
+}
+
 bool DB_RAW_V3::init(AbstractExt *extension, const std::string init_str)
 {
 	bool status;
 
-	if (extension->getDBType() == std::string("MySQL"))
+	if (extension->getDBType(database) == std::string("MySQL"))
 	{
 		status = true;
 	}
-	else if (extension->getDBType() == std::string("SQLite"))
+	else if (extension->getDBType(database) == std::string("SQLite"))
 	{
 		status = true;
 	}
@@ -51,158 +61,318 @@ bool DB_RAW_V3::init(AbstractExt *extension, const std::string init_str)
 	{
 		// DATABASE NOT SETUP YET
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: No Database Connection" << std::endl;
+			std::cout << "extDB: " << protocol_name << ": No Database Connection" << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: No Database Connection";
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": No Database Connection";
 		status = false;
 	}
 
-	if (status)
+	if (status && (flags & ADD_QUOTES_INIT))
 	{
 		if (boost::iequals(init_str, std::string("ADD_QUOTES")))
 		{
-			stringDataTypeCheck = true;
+			writer.options = NativePool::QUOTE_STRINGS | NativePool::QUOTE_EMPTY;
 			#ifdef TESTING
-				std::cout << "extDB: DB_RAW_V3: Initialized: ADD_QUOTES True" << std::endl;
+				std::cout << "extDB: " << protocol_name << ": Initialized: ADD_QUOTES True" << std::endl;
 			#endif
-			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Initialized: ADD_QUOTES True";
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Initialized: ADD_QUOTES True";
 		}
 		else
 		{
-			stringDataTypeCheck = false;
+			writer.options = 0;
 			#ifdef TESTING
-				std::cout << "extDB: DB_RAW_V3: Initialized: ADD_QUOTES False" << std::endl;
+				std::cout << "extDB: " << protocol_name << ": Initialized: ADD_QUOTES False" << std::endl;
 			#endif
-			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Initialized: ADD_QUOTES False";
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Initialized: ADD_QUOTES False";
 		}
 	}
 
 	return status;
 }
 
+bool DB_RAW_V3::getInputs(AbstractExt *extension, std::string &input_str, std::string &sql, std::vector<std::string> &inputs, std::string &result)
+// Splits Input into SQL + Values (PARAMS), SQL ends at first : outside of Quotes
+//	false = Number of Values doesn't match Number of ? Placeholders, Error Message is in result
+{
+	inputs.clear();
+	if (!(flags & PARAMS))
+	{
+		sql = input_str;
+		return true;
+	}
+
+	const std::string::size_type pos = SQL::findUnquoted(input_str, ':');
+	sql = input_str.substr(0, pos);
+	if (pos != std::string::npos)
+	{
+		boost::split(inputs, input_str.substr(pos + 1), boost::is_any_of(":"));
+	}
+
+	std::size_t placeholders = 0;
+	for (std::string::size_type i = SQL::findUnquoted(sql, '?'); i != std::string::npos; i = SQL::findUnquoted(sql, '?', i + 1))
+	{
+		++placeholders;
+	}
+	if (placeholders != inputs.size())
+	{
+		result = "[0,\"Error Incorrect Number of Inputs\"]";
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Incorrect Number of Inputs: " + input_str;
+		return false;
+	}
+	return true;
+}
+
 void DB_RAW_V3::callProtocol(AbstractExt *extension, std::string input_str, std::string &result)
+{
+	callProtocol(extension, input_str, result, nullptr);
+}
+
+void DB_RAW_V3::callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream)
 {
 	try
 	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: DEBUG INFO: " + input_str << std::endl;
+			std::cout << "extDB: " << protocol_name << ": DEBUG INFO: " + input_str << std::endl;
 		#endif
 		#ifdef DEBUG_LOGGING
-			BOOST_LOG_SEV(extension->logger, boost::log::trivial::trace) << "extDB: DB_RAW_V3: Trace: Input:" + input_str;
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::trace) << "extDB: " << protocol_name << ": Trace: Input:" + input_str;
 		#endif
 
-		Poco::Data::Session db_session = extension->getDBSession_mutexlock();
-		Poco::Data::Statement sql(db_session);
-		sql << input_str;
-		sql.execute();
-		Poco::Data::RecordSet rs(sql);
+		std::string sql_str;
+		std::vector<std::string> inputs;
+		if (!getInputs(extension, input_str, sql_str, inputs, result))
+		{
+			return;
+		}
+
+		// SELECT uses Read Replica if available
+		DBConnectionInfo *session_database = database;
+		if (isReadOnlySQL(sql_str))
+		{
+			session_database = database->getReadDatabase();
+		}
 
-		result = "[1,[";
-		std::size_t cols = rs.columnCount();
-		if (cols >= 1)
+		// Native Backend -- Rows are written straight into result, SQL it doesn't support falls back to Poco
+		bool native = false;
+		if (session_database->useNative())
 		{
-			bool more = rs.moveFirst();
-			while (more)
+			native = session_database->native->execute(sql_str, inputs, writer.options, result, stream);
+		}
+
+		if (!native)
+		{
+			// Prepared -- PARAMS Values / Normalize Raw SQL Literals are bound to a Cached Prepared Statement
+			std::string prepared_sql;
+			std::vector<SQL::Literal> literals;
+			if (flags & PARAMS)
 			{
-				result += "[";
-				for (std::size_t col = 0; col < cols; ++col)
+				prepared_sql.swap(sql_str);
+				literals.resize(inputs.size());
+				for (std::vector<std::string>::size_type i = 0; i < inputs.size(); ++i)
 				{
-					std::string temp_str = rs[col].convert<std::string>();
-					
-					if (stringDataTypeCheck)
-						if (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING)
-						{
-							if (temp_str.empty())
-							{
-								result += ("\"\"");
-							}
-							else
-							{
-								result += "\"" + temp_str + "\"";
-							}
-						}
-						else
-						{
-							if (temp_str.empty())
-							{
-								result += ("\"\"");
-							}
-							else
-							{
-								result += temp_str;
-							}
-						}
-					else
-					{
-						result += temp_str;
-					}
-					if (col < (cols - 1))
-					{
-						result += ",";
-					}
+					literals[i].string = true;
+					literals[i].string_value.swap(inputs[i]);
+					literals[i].int_value = 0;
 				}
-				more = rs.moveNext();
-				if (more)
+				preparedCallProtocol(extension, session_database, prepared_sql, literals, result, stream);
+			}
+			else if (session_database->normalize_raw_sql && SQL::normalize(sql_str, (extension->getDBType(session_database) == "MySQL"), prepared_sql, literals))
+			{
+				preparedCallProtocol(extension, session_database, prepared_sql, literals, result, stream);
+			}
+			else
+			{
+				Poco::Data::Session db_session = extension->getDBSession_mutexlock(session_database);
+				Poco::Data::Statement sql(db_session);
+				sql << sql_str;
+				try
 				{
-					result += "],";
+					sql.execute();
 				}
-				else
+				catch (Poco::Data::MySQL::ConnectionException&)
 				{
-					result += "]";
+					// Broken DB Session, close it instead of putting it back
+					extension->invalidateDBSession_mutexlock(session_database, db_session);
+					throw;
 				}
+				getResult(sql, result, stream);
 			}
 		}
-		result += "]]";
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Trace: Result:" + result << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Trace: Result:" + result << std::endl;
 		#endif
 		#ifdef DEBUG_LOGGING
-			BOOST_LOG_SEV(extension->logger, boost::log::trivial::trace) << "extDB: DB_RAW_V3: Trace: Result: " + result;
+			BOOST_LOG_SEV(extension->logger, boost::log::trivial::trace) << "extDB: " << protocol_name << ": Trace: Result: " + result;
 		#endif
 	}
 	catch (Poco::Data::SQLite::DBLockedException& e)
 	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Error Database Locked Exception: " + e.displayText() << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Error Database Locked Exception: " + e.displayText() << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error DBLockedException: " + e.displayText();
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error DBLockedException: Input:" + input_str;
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error DBLockedException: " + e.displayText();
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error DBLockedException: Input:" + input_str;
 		result = "[0,\"Error DBLocked Exception\"]";
 	}
 	catch (Poco::Data::MySQL::ConnectionException& e)
 	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Error ConnectionException: " + e.displayText() << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Error ConnectionException: " + e.displayText() << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error ConnectionException: " + e.displayText();
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error ConnectionException: Input:" + input_str;
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error ConnectionException: " + e.displayText();
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error ConnectionException: Input:" + input_str;
 		result = "[0,\"Error Connection Exception\"]";
 	}
 	catch(Poco::Data::MySQL::StatementException& e)
 	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Error StatementException: " + e.displayText() << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Error StatementException: " + e.displayText() << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error StatementException: " + e.displayText();
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error StatementException: Input:" + input_str;
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error StatementException: " + e.displayText();
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error StatementException: Input:" + input_str;
 		result = "[0,\"Error Statement Exception\"]";
 	}
 	catch (Poco::Data::DataException& e)
-    {
+	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Error DataException: " + e.displayText() << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Error DataException: " + e.displayText() << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error DataException: " + e.displayText();
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error DataException: Input:" + input_str;
-        result = "[0,\"Error Data Exception\"]";
-    }
-    catch (Poco::Exception& e)
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error DataException: " + e.displayText();
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error DataException: Input:" + input_str;
+		result = "[0,\"Error Data Exception\"]";
+	}
+	catch (Poco::Exception& e)
 	{
 		#ifdef TESTING
-			std::cout << "extDB: DB_RAW_V3: Error Exception: " + e.displayText() << std::endl;
+			std::cout << "extDB: " << protocol_name << ": Error Exception: " + e.displayText() << std::endl;
 		#endif
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error Exception: " + e.displayText();
-		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: DB_RAW_V3: Error Exception: Input:" + input_str;
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error Exception: " + e.displayText();
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::warning) << "extDB: " << protocol_name << ": Error Exception: Input:" + input_str;
 		result = "[0,\"Error Exception\"]";
 	}
-}
\ No newline at end of file
+}
+
+void DB_RAW_V3::preparedCallProtocol(AbstractExt *extension, DBConnectionInfo *session_database, const std::string &prepared_sql, std::vector<SQL::Literal> &literals, std::string &result, ResultStream *stream)
+// Runs SQL as a Prepared Statement from Statement Cache of DB Session, prepares + caches it if missing
+//	Errors are thrown same as Poco Path, Statement is removed from Statement Cache on Error
+{
+	Poco::Data::SessionPool::SessionList::iterator session_itr;
+	Poco::Data::Session session = extension->getDBSessionCustom_mutexlock(session_database, session_itr);
+	try
+	{
+		Poco::Data::SessionPool::StatementCache *statement_cache = session_itr->second.find(prepared_sql);
+		if (statement_cache == nullptr)
+		{
+			Poco::Data::SessionPool::StatementCache new_statement_cache;
+			Poco::Timestamp prepare_start;
+			Poco::Data::Statement sql_statement(session);
+			sql_statement << prepared_sql;
+			sql_statement.extDB_prepare();
+			new_statement_cache.push_back(std::move(sql_statement));
+			statement_cache = &(session_itr->second.insert(prepared_sql, new_statement_cache, prepare_start.elapsed()));
+		}
+
+		Poco::Data::Statement &sql = (*statement_cache)[0];
+		sql.bindClear();
+		for (std::vector<SQL::Literal>::iterator itr = literals.begin(); itr != literals.end(); ++itr)
+		{
+			if (itr->string)
+			{
+				sql, Poco::Data::use(itr->string_value);
+			}
+			else
+			{
+				sql, Poco::Data::use(itr->int_value);
+			}
+		}
+		sql.bindFixup();
+		try
+		{
+			sql.execute();
+		}
+		catch (Poco::Data::MySQL::ConnectionException&)
+		{
+			// Broken DB Session, close it instead of putting it back
+			extension->invalidateDBSessionCustom_mutexlock(session_database, session_itr);
+			throw;
+		}
+		getResult(sql, result, stream);
+	}
+	catch (Poco::Exception&)
+	{
+		session_itr->second.erase(prepared_sql);
+		extension->putbackDBSession_mutexlock(session_database, session_itr);
+		throw;
+	}
+	extension->putbackDBSession_mutexlock(session_database, session_itr);
+}
+
+void DB_RAW_V3::getResult(Poco::Data::Statement &sql, std::string &result, ResultStream *stream)
+// Same Output as Native Backends, Values are written by writer
+{
+	Poco::Data::RecordSet rs(sql);
+
+	result = "[1,[";
+	std::size_t cols = rs.columnCount();
+	if (cols >= 1)
+	{
+		std::string temp_str;
+		bool more = rs.moveFirst();
+		while (more)
+		{
+			result += "[";
+			for (std::size_t col = 0; col < cols; ++col)
+			{
+				if (col > 0)
+				{
+					result += ",";
+				}
+				temp_str = rs[col].convert<std::string>();
+				writer(col, temp_str.data(), temp_str.size(), (rs.columnType(col) == Poco::Data::MetaColumn::FDT_STRING), result);
+			}
+			result += "]";
+			// Published on a Row boundary, so an Error Trailer can close the Rows
+			if ((stream != nullptr) && stream->ready(result))
+			{
+				stream->publish(result);
+			}
+			more = rs.moveNext();
+			if (more)
+			{
+				result += ",";
+			}
+		}
+	}
+	result += "]]";
+}
+
+boost::shared_ptr<ResultCursor> DB_RAW_V3::openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result)
+// Cursors always run on Poco (no Native Backend), Values same as callProtocol
+{
+	#ifdef DEBUG_LOGGING
+		BOOST_LOG_SEV(extension->logger, boost::log::trivial::trace) << "extDB: " << protocol_name << ": Trace: Cursor Input:" + input_str;
+	#endif
+
+	std::string sql;
+	std::vector<std::string> inputs;
+	if (!getInputs(extension, input_str, sql, inputs, result))
+	{
+		return boost::shared_ptr<ResultCursor>();
+	}
+
+	DBConnectionInfo *session_database = database;
+	if (isReadOnlySQL(sql))
+	{
+		session_database = database->getReadDatabase();
+	}
+
+	const NativePool::OptionsWriter options_writer(writer);
+	boost::shared_ptr<DBCursor> cursor(new DBCursor(extension, session_database, page_size,
+		[options_writer](std::size_t col, std::string &value, bool string_type, std::string &value_result) -> bool
+		{
+			options_writer(col, value.data(), value.size(), string_type, value_result);
+			return true;
+		}));
+	cursor->open(std::vector<std::string>(1, sql), std::vector< std::vector<std::string> >(1, inputs));
+	return cursor;
+}
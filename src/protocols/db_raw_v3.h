@@ -18,16 +18,38 @@ along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <Poco/Data/Statement.h>
+
 #include "abstract_ext.h"
 #include "abstract_protocol.h"
+#include "../backends/native_pool.h"
+#include "../sql_normalize.h"
 
 
 class DB_RAW_V3: public AbstractProtocol
+// Raw SQL Engine of DB_RAW_V2 / DB_RAW_NO_EXTRA_QUOTES_V2 / DB_RAW_V3 / DB_RAW_PARAMS_V3
+//	Protocols only differ by Name, Quoting Policy + Input, Execution (Native / Prepared / Poco) + Output are shared
 {
 	public:
+		enum Flags {
+			ADD_QUOTES_INIT = 1,  // Quoting Policy is set by Init Option ADD_QUOTES
+			PARAMS = 2            // Input = SQL:VALUE1:VALUE2, Values are bound to ? Placeholders
+		};
+
+		// quote_options = NativePool::Options
+		DB_RAW_V3(const std::string &name, int quote_options, int flags);
+
 		bool init(AbstractExt *extension, const std::string init_str);
 		void callProtocol(AbstractExt *extension, std::string input_str, std::string &result);
+		void callProtocol(AbstractExt *extension, std::string input_str, std::string &result, ResultStream *stream);
+		boost::shared_ptr<ResultCursor> openCursor(AbstractExt *extension, std::string input_str, std::size_t page_size, std::string &result);
 
 	private:
-		bool stringDataTypeCheck;
+		std::string protocol_name;
+		int flags;
+		NativePool::OptionsWriter writer;  // Quoting Policy, used by every Execution Path
+
+		bool getInputs(AbstractExt *extension, std::string &input_str, std::string &sql, std::vector<std::string> &inputs, std::string &result);
+		void preparedCallProtocol(AbstractExt *extension, DBConnectionInfo *session_database, const std::string &prepared_sql, std::vector<SQL::Literal> &literals, std::string &result, ResultStream *stream);
+		void getResult(Poco::Data::Statement &sql, std::string &result, ResultStream *stream);
 };
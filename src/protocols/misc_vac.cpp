@@ -259,7 +259,7 @@ From Frank https://gist.github.com/Fank/11127158
 		t_arg[0]
 		if (isNumber(input_str))
 		{
-			Poco::Data::Session db_session = extension->getDBSession_mutexlock();
+			Poco::Data::Session db_session = extension->getDBSession_mutexlock(database);
 			Poco::Data::Statement select(db_session);
 			select << ("SELECT \"Number of Vac Bans\" FROM `VAC BANS` where SteamID="  + input_str), now;
 			Poco::Data::RecordSet rs(select);
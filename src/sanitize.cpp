@@ -89,6 +89,21 @@ namespace Sqf
 			return r;
 		}
 	};
+
+	bool parse(std::string input_str, Value &value)
+	{
+		std::string::iterator first = input_str.begin();
+		std::string::iterator last = input_str.end();
+
+		bool r = boost::spirit::qi::phrase_parse(
+			first,
+			last,
+			SqfValueParser<iter_t,boost::spirit::qi::space_type>(),
+			boost::spirit::qi::space_type(),
+			value
+		);
+		return (r && (first == last));
+	};
 }
 
 
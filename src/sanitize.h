@@ -37,4 +37,6 @@ namespace Sqf
 	typedef std::string::iterator iter_t;
 
 	bool check(std::string input_str);
+	// Parses one SQF Value i.e [[1,"abc"],[2,"def"]], false = not a valid SQF Value
+	bool parse(std::string input_str, Value &value);
 }
\ No newline at end of file
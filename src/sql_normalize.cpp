@@ -0,0 +1,278 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "sql_normalize.h"
+
+#include <Poco/NumberParser.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cctype>
+
+
+namespace
+{
+	bool isWordChar(const char c)
+	{
+		return (std::isalnum((unsigned char) c) != 0) || (c == '_') || (c == '$');
+	}
+}
+
+
+bool SQL::normalize(const std::string &sql, bool mysql, std::string &normalized, std::vector<Literal> &literals)
+{
+	normalized.clear();
+	literals.clear();
+	normalized.reserve(sql.size());
+
+	bool first_word = true;
+	bool placeholders = false;  // Literals of current Clause are replaced
+	std::vector<bool> placeholders_brackets;  // Clause outside of each open Bracket
+
+	const std::string::size_type size = sql.size();
+	std::string::size_type i = 0;
+	while (i < size)
+	{
+		const char c = sql[i];
+		const std::string::size_type start = i;
+
+		if (c == '\'')
+		{
+			// String Literal, '' = '
+			if ((i > 0) && isWordChar(sql[i - 1]))
+			{
+				// Introducer i.e _utf8'abc' N'abc' X'0F'
+				return false;
+			}
+			Literal literal;
+			literal.string = true;
+			literal.int_value = 0;
+			bool closed = false;
+			for (++i; i < size; ++i)
+			{
+				if (sql[i] == '\'')
+				{
+					if (((i + 1) < size) && (sql[i + 1] == '\''))
+					{
+						literal.string_value += '\'';
+						++i;
+						continue;
+					}
+					closed = true;
+					++i;
+					break;
+				}
+				if (mysql && (sql[i] == '\\'))
+				{
+					return false;
+				}
+				literal.string_value += sql[i];
+			}
+			if (!closed)
+			{
+				return false;
+			}
+			if (placeholders)
+			{
+				normalized += '?';
+				literals.push_back(std::move(literal));
+			}
+			else
+			{
+				normalized.append(sql, start, i - start);
+			}
+		}
+		else if ((c == '"') || (c == '`'))
+		{
+			// Quoted Identifier, MySQL "" String is kept as it is
+			bool closed = false;
+			for (++i; i < size; ++i)
+			{
+				if (sql[i] == c)
+				{
+					if (((i + 1) < size) && (sql[i + 1] == c))
+					{
+						++i;
+						continue;
+					}
+					closed = true;
+					++i;
+					break;
+				}
+				if (mysql && (c == '"') && (sql[i] == '\\'))
+				{
+					return false;
+				}
+			}
+			if (!closed)
+			{
+				return false;
+			}
+			normalized.append(sql, start, i - start);
+		}
+		else if (std::isdigit((unsigned char) c) && ((i == 0) || ((!isWordChar(sql[i - 1])) && (sql[i - 1] != '.'))))
+		{
+			// Number, only Integers are replaced -- Decimals, Floats + Hex are kept as they are
+			bool integer = true;
+			while ((i < size) && std::isdigit((unsigned char) sql[i]))
+			{
+				++i;
+			}
+			if ((i < size) && (sql[i] == '.'))
+			{
+				integer = false;
+				for (++i; (i < size) && std::isdigit((unsigned char) sql[i]); ++i) {}
+			}
+			if ((i < size) && ((sql[i] == 'e') || (sql[i] == 'E')))
+			{
+				integer = false;
+				++i;
+				if ((i < size) && ((sql[i] == '+') || (sql[i] == '-')))
+				{
+					++i;
+				}
+			}
+			for (; (i < size) && isWordChar(sql[i]); ++i)
+			{
+				integer = false;
+			}
+
+			Literal literal;
+			literal.string = false;
+			if (placeholders && integer && Poco::NumberParser::tryParse64(sql.substr(start, i - start), literal.int_value))
+			{
+				normalized += '?';
+				literals.push_back(std::move(literal));
+			}
+			else
+			{
+				normalized.append(sql, start, i - start);
+			}
+		}
+		else if (isWordChar(c))
+		{
+			if ((!mysql) && (c == '$'))
+			{
+				// SQLite Named Parameter
+				return false;
+			}
+			for (; (i < size) && isWordChar(sql[i]); ++i) {}
+			const std::string word = boost::algorithm::to_upper_copy(sql.substr(start, i - start));
+			if (first_word)
+			{
+				if ((word != "SELECT") && (word != "INSERT") && (word != "UPDATE") && (word != "DELETE") && (word != "REPLACE"))
+				{
+					return false;
+				}
+				first_word = false;
+			}
+
+			if ((word == "WHERE") || (word == "SET") || (word == "VALUES") || (word == "VALUE") || (word == "HAVING") || (word == "ON") || (word == "LIMIT") || (word == "OFFSET"))
+			{
+				placeholders = true;
+			}
+			else if ((word == "SELECT") || (word == "FROM") || (word == "INTO") || (word == "ORDER") || (word == "GROUP") || (word == "UNION") || (word == "RETURNING"))
+			{
+				placeholders = false;
+			}
+			else if ((word == "CAST") || (word == "CONVERT") || (word == "AGAINST"))
+			{
+				// Type Lengths + Full Text Search need Constants
+				return false;
+			}
+			normalized.append(sql, start, i - start);
+		}
+		else if (c == '(')
+		{
+			placeholders_brackets.push_back(placeholders);
+			normalized += c;
+			++i;
+		}
+		else if (c == ')')
+		{
+			if (!placeholders_brackets.empty())
+			{
+				placeholders = placeholders_brackets.back();
+				placeholders_brackets.pop_back();
+			}
+			normalized += c;
+			++i;
+		}
+		else if (std::isspace((unsigned char) c))
+		{
+			// Whitespace is collapsed, so SQL Shape doesn't depend on it
+			if ((!normalized.empty()) && (normalized[normalized.size() - 1] != ' '))
+			{
+				normalized += ' ';
+			}
+			++i;
+		}
+		else if (c == ';')
+		{
+			if (sql.find_first_not_of(" \t\r\n;", i) != std::string::npos)
+			{
+				// Multiple Statements
+				return false;
+			}
+			break;
+		}
+		else if ((c == '?') || (mysql && (c == '#')) || ((!mysql) && ((c == ':') || (c == '@'))) ||
+					((c == '-') && ((i + 1) < size) && (sql[i + 1] == '-')) ||
+					((c == '/') && ((i + 1) < size) && (sql[i + 1] == '*')))
+		{
+			// Placeholder, Named Parameter or Comment
+			return false;
+		}
+		else
+		{
+			normalized += c;
+			++i;
+		}
+	}
+
+	while ((!normalized.empty()) && (normalized[normalized.size() - 1] == ' '))
+	{
+		normalized.erase(normalized.size() - 1);
+	}
+	return !first_word;
+}
+
+
+std::string::size_type SQL::findUnquoted(const std::string &sql, char c, std::string::size_type pos)
+{
+	char quote = '\0';
+	for (; pos < sql.size(); ++pos)
+	{
+		if (quote != '\0')
+		{
+			if (sql[pos] == quote)
+			{
+				quote = '\0';
+			}
+		}
+		else if (sql[pos] == c)
+		{
+			return pos;
+		}
+		else if ((sql[pos] == '\'') || (sql[pos] == '"') || (sql[pos] == '`'))
+		{
+			quote = sql[pos];
+		}
+	}
+	return std::string::npos;
+}
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2014 Declan Ireland <http://github.com/torndeco/extDB>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <Poco/Types.h>
+
+#include <string>
+#include <vector>
+
+
+namespace SQL
+{
+	struct Literal {
+		bool string;
+		std::string string_value;
+		Poco::Int64 int_value;
+	};
+
+	// Replaces Integer + String Literals of WHERE / SET / VALUES / HAVING / ON / LIMIT with ? Placeholders
+	//	normalized = SQL Shape (Fingerprint), literals = Values in Placeholder Order
+	//	Literals in Select List, ORDER BY + GROUP BY are kept, so Result Columns are the same
+	//	false = SQL isn't normalized i.e Comments, Placeholders, Multiple Statements, CAST
+	//	mysql = Backslash Escapes + # Comments, else SQLite (Named Parameters)
+	bool normalize(const std::string &sql, bool mysql, std::string &normalized, std::vector<Literal> &literals);
+
+	// Position of first c outside of Quotes + Quoted Identifiers from pos, npos if not found
+	std::string::size_type findUnquoted(const std::string &sql, char c, std::string::size_type pos = 0);
+}